@@ -5,31 +5,53 @@ BaseEntity::BaseEntity()
 {
 	m_hasPath = false;
 	m_path = nullptr;
+	m_pathTicket = c_noPathTicket;
+	m_requestAlgo = ALGO_A_STAR;
+	m_planner = nullptr;
 	m_timePassed = 0.0f;
 	m_velocity = 0.0f;
 	m_vecVel = glm::vec2(0.0f,0.0f);
 	m_maxVel = 0.15f;
 }
 
-// Destructor - deletes necessary objects to prevent memory leaks
-BaseEntity::~BaseEntity() {}
+// Destructor - deletes necessary objects to prevent memory leaks. The path is owned here rather than by the
+// inheriting classes, and is taken out of the map's watch list before it is deleted. The planner may still be in
+// use by a search on one of the map's workers, so that search is stopped first
+BaseEntity::~BaseEntity()
+{
+	m_map->CancelPath(m_pathTicket);
+
+	m_map->UnwatchPath(m_path);
+	delete m_path;
+
+	if(m_planner != nullptr)
+	{
+		m_map->ReleasePlanner(m_planner);
+		delete m_planner;
+	}
+}
 
 // Getters
 
 glm::vec2 BaseEntity::GetPosition() { return m_pos; }
 glm::vec2 BaseEntity::GetDestination() { return m_destination; }
+Path* BaseEntity::GetPath() { return m_path; }
+
+// Returns whether the entity is waiting on a path it has requested
+bool BaseEntity::IsSearching() { return m_pathTicket != c_noPathTicket; }
 
 // Setters
 
 // Sets the position of the base entity
-// If it has a path delete it and request a new one from the updated position
+// If it has a path, or is still waiting for one from the old position, the path and request are thrown away and a
+// new one is requested from the updated position
 void BaseEntity::SetPosition(glm::vec2 _pos)
 {
 	m_pos = _pos;
 
-	if(m_hasPath)
+	if(m_hasPath || IsSearching())
 	{
-		int tempAlgo = m_path->GetAlgoType();
+		int tempAlgo = m_hasPath ? m_path->GetAlgoType() : m_requestAlgo;
 		ClearPath();
 		RequestPath(tempAlgo);
 	}
@@ -48,6 +70,9 @@ void BaseEntity::MoveEntity()
 	else
 		m_timePassed += 0.03333333;
 
+	// Picks up the path requested on an earlier frame, if it is ready, before moving along the current path
+	CollectPath();
+
 	if(m_hasPath)
 	{
 		// If the entity is within the specified distance of the destination clear their path
@@ -66,47 +91,102 @@ void BaseEntity::MoveEntity()
 				m_nextPoint = m_destination;
 		}
 
-		// Calculates the vector from the current position to the destination and normalises it
-		m_targetVel = glm::normalize(m_nextPoint - m_pos) * m_maxVel;
-		m_steering = m_targetVel - m_vecVel;
-		m_steering.x *= 0.05f;
-		m_steering.y *= 0.05f;
-		
-		// If the entity is not at maximum velocity increase its speed
-		if(m_velocity < m_maxVel)
-			m_velocity += 0.01;
-
-		// Applies the steering force to the current velocity
-		m_vecVel += m_steering;
-
-		// Updates the enemy position based on direction and velocity
-		m_pos += m_vecVel;
+		SteerTowards(m_nextPoint);
 	}
 }
 
-// Requests a path to the base entity's destination from it's current position
+// Steers the entity towards the given point and moves it based on direction and velocity
+void BaseEntity::SteerTowards(glm::vec2 _point)
+{
+	// Calculates the vector from the current position to the point and normalises it
+	m_targetVel = glm::normalize(_point - m_pos) * m_maxVel;
+	m_steering = m_targetVel - m_vecVel;
+	m_steering.x *= 0.05f;
+	m_steering.y *= 0.05f;
+	
+	// If the entity is not at maximum velocity increase its speed
+	if(m_velocity < m_maxVel)
+		m_velocity += 0.01;
+
+	// Applies the steering force to the current velocity
+	m_vecVel += m_steering;
+
+	// Updates the enemy position based on direction and velocity
+	m_pos += m_vecVel;
+}
+
+// Requests a path to the base entity's destination from it's current position. The path is searched for on the
+// map's background workers and picked up on a later frame, and until then the entity keeps following the path
+// it already has. A request that is still waiting is replaced, as it is heading for an old destination
 void BaseEntity::RequestPath(int _algoType)
 {
+	// D* Lite keeps its search state between requests so each entity that uses it has its own planner. This only
+	// pays off while the destination stays the same, such as the player following a set destination
+	if(_algoType == ALGO_D_STAR_LITE && m_planner == nullptr)
+		m_planner = new DStarLite(m_map, m_isPlayer);
+
+	m_map->CancelPath(m_pathTicket);
+	m_requestAlgo = _algoType;
+
+	// Request a new path from the map, providing the start position, end position and type of algorithm we want to use
+	m_pathTicket = m_map->RequestPathAsync(m_pos, m_destination, _algoType, m_isPlayer, m_planner);
+}
+
+// Swaps the requested path in for the old one once its search has finished
+void BaseEntity::CollectPath()
+{
+	if(!IsSearching())
+		return;
+
+	Path *newPath = m_map->CollectPath(m_pathTicket);
+
+	if(newPath == nullptr)
+		return;
+
+	m_pathTicket = c_noPathTicket;
+
 	// If there is already a path delete it
 	if(m_path != nullptr)
+	{
+		m_map->UnwatchPath(m_path);
 		delete m_path;
+	}
 
-	// Request a new path from the map, providing the start position, end position and type of algorithm we want to use
-	m_path = m_map->GetPath(m_pos, m_destination, _algoType, m_isPlayer);
+	m_path = newPath;
 
-	// If there is a path on the path object update the next point for the entity to head to and it's current/target heading
+	// If there is a path on the path object update the next point for the entity to head to and it's current/target heading.
+	// The map marks the path as invalidated if any tile still ahead on it changes
 	if(m_path->PathExists())
 	{
+		m_map->WatchPath(m_path);
 		m_hasPath = true;
 		m_nextPoint = m_path->GetNextPoint();
 		m_targetVel = glm::normalize(m_nextPoint - m_pos) * m_maxVel;
 		m_steering = m_targetVel - m_vecVel;
 	}
+
+	// Otherwise the path is kept so its message can be shown, but the entity stops following it
+	else
+		m_hasPath = false;
+}
+
+// Repairs a D* Lite path if the map has changed since it was generated. Only the part of the search affected by
+// the changes is redone and the entity keeps moving at its current velocity
+void BaseEntity::RepairPath()
+{
+	if(!m_hasPath || IsSearching() || m_path->GetMapVersion() >= m_map->GetCostVersion(m_path->IsPlayerPath()))
+		return;
+
+	RequestPath(ALGO_D_STAR_LITE);
 }
 
-// Clears the previous path object and all necessary flags on the object
+// Clears the previous path object and all necessary flags on the object, and cancels any path still being searched for
 void BaseEntity::ClearPath()
 {
+	m_map->CancelPath(m_pathTicket);
+	m_pathTicket = c_noPathTicket;
+
+	m_map->UnwatchPath(m_path);
 	delete m_path;
 	m_path = nullptr;
 	m_hasPath = false;
@@ -118,5 +198,4 @@ void BaseEntity::ClearPath()
 
 // Functions defined by inheriting classes
 void BaseEntity::Update() {}
-void BaseEntity::TimedUpdate() {}
-void BaseEntity::Render() {}
\ No newline at end of file
+void BaseEntity::TimedUpdate() {}
\ No newline at end of file
@@ -3,39 +3,42 @@
 
 #include "glm/glm.hpp"
 #include "Path.h"
-#include "allegro5\allegro.h"
 #include "Map.h"
+#include "DStarLite.h"
+#include "PathQueue.h"
 
 class BaseEntity
 {
 	public:
 		// Constructor and destructor
 		BaseEntity();
-		~BaseEntity();
+		virtual ~BaseEntity();
 
 		// Getters
 		glm::vec2 GetPosition();
 		glm::vec2 GetDestination();
+		Path* GetPath();
+		bool IsSearching();
 
 		// Setters
 		void SetPosition(glm::vec2 _startPos);
 		
 		void MoveEntity();
+		void SteerTowards(glm::vec2 _point);
 
 		void RequestPath(int _algoType);
+		void CollectPath();
+		void RepairPath();
 		void ClearPath();
 
 		// Functions to be defined by classes inheriting from this class
 		virtual void Update();
 		virtual void TimedUpdate();
-		virtual void Render();
 
 	protected:
 		bool m_hasPath;
 		bool m_isPlayer;
 
-		float m_spriteWidth;
-		float m_spriteHeight;
 		float m_maxVel;
 		float m_velocity;
 		float m_timePassed;
@@ -48,9 +51,10 @@ class BaseEntity
 		glm::vec2 m_steering;
 		
 		Path *m_path;
+		int m_pathTicket;
+		int m_requestAlgo;
 		Map *m_map;
-
-		ALLEGRO_BITMAP *m_sprite;
+		DStarLite *m_planner;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,400 @@
+// Standalone benchmark for the pathfinding code. It loads a map file without creating a display and runs
+// the same seeded set of start and end points for each algorithm, with diagonal movement on and off, then
+// writes the latency percentiles, expansions and throughput of each run as JSON or CSV. A Star is run with both
+// the landmark heuristic it uses by default and with landmarks turned off, when it uses the distance scaled by the
+// cheapest terrain, and how many expansions the landmarks save or add is reported. Every path found with diagonal movement off is checked for diagonal steps, which would
+// mean a path from before the toggle was handed out, and the benchmark exits with an error if any are found.
+//
+// This file has its own main and is built as a separate executable from Main.cpp, linked only against the
+// pathfinding core, which doesn't use Allegro: Node, Map, Path, SearchContext, OpenList, JumpPointSearch,
+// ClusterGraph, DStarLite, BidirectionalSearch, DistanceField, Landmarks, ThreadPool, PathCache, MapFile,
+// ChunkStore, ConnectedComponents, PathSearch, PathQueue, OccupancyMap and PathWatcher.
+// The map file can be a text map or a binary map written by MapConvert.
+//
+// Usage: Benchmark [map file] [--queries N] [--seed N] [--algos 0,1,...] [--format json|csv] [--output file] [--cache]
+//                  [--node-budget KB]
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "Map.h"
+#include "PathCache.h"
+#include "DStarLite.h"
+
+// Width and height in pixels of the map, matching the size used by the simulation
+const int c_benchMapWidth = 1000;
+const int c_benchMapHeight = 1000;
+
+// Number of queries run before each timed run to warm up the caches and search buffers
+const int c_numWarmupQueries = 50;
+
+// Settings read from the command line
+struct BenchmarkSettings
+{
+	std::string mapFile;
+	std::string format;
+	std::string outputFile;
+	int numQueries;
+	unsigned int seed;
+	bool useCache;
+	int nodeBudgetKB;
+	std::vector<int> algoTypes;
+};
+
+// Results of running every query with one algorithm and diagonal setting
+struct BenchmarkResult
+{
+	int algoType;
+	bool diagonals;
+	std::string heuristic;
+	int numQueries;
+	int numFound;
+	double queriesPerSecond;
+	double meanExpansions;
+	int maxExpansions;
+	long long meanNanoseconds;
+	long long p50Nanoseconds;
+	long long p90Nanoseconds;
+	long long p99Nanoseconds;
+	long long maxNanoseconds;
+	int numDiagonalPaths;
+};
+
+// Returns the name used in the output for an algorithm type
+std::string GetAlgoName(int _algoType)
+{
+	switch(_algoType)
+	{
+		case ALGO_A_STAR: return "a_star";
+		case ALGO_DIJKSTRA: return "dijkstra";
+		case ALGO_JUMP_POINT: return "jump_point";
+		case ALGO_JUMP_POINT_PLUS: return "jump_point_plus";
+		case ALGO_HIERARCHICAL: return "hierarchical";
+		case ALGO_D_STAR_LITE: return "d_star_lite";
+		case ALGO_BIDIRECTIONAL_A_STAR: return "bidirectional_a_star";
+		case ALGO_BIDIRECTIONAL_DIJKSTRA: return "bidirectional_dijkstra";
+		default: return "unknown";
+	}
+}
+
+// Returns the value at the given percentile of a sorted list using the nearest rank
+long long GetPercentile(std::vector<long long> &_sorted, double _percentile)
+{
+	if(_sorted.empty())
+		return 0;
+
+	int rank = (int)std::ceil(_percentile / 100.0 * _sorted.size());
+
+	return _sorted[std::max(rank, 1) - 1];
+}
+
+// Reads the settings from the command line. Returns false if an argument isn't recognised
+bool ParseSettings(int _argc, char *_argv[], BenchmarkSettings &_settings)
+{
+	_settings.mapFile = "Base Map.txt";
+	_settings.format = "json";
+	_settings.outputFile = "";
+	_settings.numQueries = 1000;
+	_settings.seed = 12345;
+	_settings.useCache = false;
+	_settings.nodeBudgetKB = 0;
+	_settings.algoTypes.clear();
+
+	for(int i = 1; i < _argc; i++)
+	{
+		std::string arg = _argv[i];
+		bool hasValue = (i + 1 < _argc);
+
+		if(arg == "--queries" && hasValue)
+			_settings.numQueries = std::atoi(_argv[++i]);
+		else if(arg == "--seed" && hasValue)
+			_settings.seed = std::strtoul(_argv[++i], nullptr, 10);
+		else if(arg == "--format" && hasValue)
+			_settings.format = _argv[++i];
+		else if(arg == "--output" && hasValue)
+			_settings.outputFile = _argv[++i];
+		else if(arg == "--algos" && hasValue)
+		{
+			std::stringstream algoStream(_argv[++i]);
+			std::string algo;
+
+			while(std::getline(algoStream, algo, ','))
+				_settings.algoTypes.push_back(std::atoi(algo.c_str()));
+		}
+		else if(arg == "--node-budget" && hasValue)
+			_settings.nodeBudgetKB = std::atoi(_argv[++i]);
+		else if(arg == "--cache")
+			_settings.useCache = true;
+		else if(arg.compare(0, 2, "--") != 0)
+			_settings.mapFile = arg;
+		else
+			return false;
+	}
+
+	if(_settings.algoTypes.empty())
+	{
+		_settings.algoTypes.push_back(ALGO_A_STAR);
+		_settings.algoTypes.push_back(ALGO_DIJKSTRA);
+	}
+
+	return _settings.numQueries > 0 && (_settings.format == "json" || _settings.format == "csv");
+}
+
+// Picks pairs of different traversable tiles using the seed, so every run with the same seed and map uses the
+// same queries
+void GenerateQueries(Map &_map, unsigned int _seed, int _numQueries, std::vector<glm::vec2> &_starts, std::vector<glm::vec2> &_ends)
+{
+	std::vector<int> traversable;
+
+	for(int n = 0; n < _map.GetNumNodes(); n++)
+	{
+		if(_map.GetNode(n).IsTraversable())
+			traversable.push_back(n);
+	}
+
+	if(traversable.size() < 2)
+		return;
+
+	std::mt19937 rng(_seed);
+	std::uniform_int_distribution<int> pick(0, traversable.size() - 1);
+
+	while((int)_starts.size() < _numQueries)
+	{
+		int start = traversable[pick(rng)];
+		int end = traversable[pick(rng)];
+
+		if(start == end)
+			continue;
+
+		_starts.push_back(_map.GetNode(start).GetPos());
+		_ends.push_back(_map.GetNode(end).GetPos());
+	}
+}
+
+// Returns whether any step of the path moves diagonally
+bool HasDiagonalStep(Path *_path)
+{
+	const std::vector<PathPoint> &points = _path->GetNodes();
+
+	for(unsigned int i = 0; i + 1 < points.size(); i++)
+	{
+		if(points[i].tileX != points[i + 1].tileX && points[i].tileY != points[i + 1].tileY)
+			return true;
+	}
+
+	return false;
+}
+
+// Runs every query with the given algorithm and returns the timings. The latency of each query is the search
+// time recorded on its path, and the throughput includes creating and deleting the path objects. D* Lite is
+// given a planner, as the map would otherwise run A Star in its place. Each query has a new goal, so every
+// D* Lite query is a full search rather than a repair
+BenchmarkResult RunQueries(Map &_map, int _algoType, std::vector<glm::vec2> &_starts, std::vector<glm::vec2> &_ends)
+{
+	BenchmarkResult result;
+	result.algoType = _algoType;
+	result.diagonals = _map.DiagsAllowed();
+	result.heuristic = (_algoType == ALGO_A_STAR) ? (_map.LandmarksEnabled() ? "landmarks" : "octile") : "default";
+	result.numQueries = _starts.size();
+	result.numFound = 0;
+	result.maxExpansions = 0;
+	result.numDiagonalPaths = 0;
+
+	DStarLite *planner = (_algoType == ALGO_D_STAR_LITE) ? new DStarLite(&_map, true) : NULL;
+
+	for(int i = 0; i < (int)_starts.size() && i < c_numWarmupQueries; i++)
+		delete _map.GetPath(_starts[i], _ends[i], _algoType, true, OPEN_LIST_BINARY_HEAP, planner);
+
+	std::vector<long long> latencies;
+	long long totalExpansions = 0;
+	long long totalNanoseconds = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for(unsigned int i = 0; i < _starts.size(); i++)
+	{
+		Path *path = _map.GetPath(_starts[i], _ends[i], _algoType, true, OPEN_LIST_BINARY_HEAP, planner);
+
+		if(path->PathExists())
+			result.numFound++;
+
+		latencies.push_back(path->GetCalcTime());
+		totalNanoseconds += path->GetCalcTime();
+		totalExpansions += path->GetNumOps();
+		result.maxExpansions = std::max(result.maxExpansions, path->GetNumOps());
+
+		// Paths found with diagonal moves must not be handed out, even from the cache, once they are turned off
+		if(!result.diagonals && HasDiagonalStep(path))
+			result.numDiagonalPaths++;
+
+		delete path;
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	delete planner;
+
+	std::sort(latencies.begin(), latencies.end());
+
+	result.queriesPerSecond = (seconds > 0.0) ? _starts.size() / seconds : 0.0;
+	result.meanExpansions = (double)totalExpansions / _starts.size();
+	result.meanNanoseconds = totalNanoseconds / (long long)_starts.size();
+	result.p50Nanoseconds = GetPercentile(latencies, 50.0);
+	result.p90Nanoseconds = GetPercentile(latencies, 90.0);
+	result.p99Nanoseconds = GetPercentile(latencies, 99.0);
+	result.maxNanoseconds = latencies.back();
+
+	return result;
+}
+
+// Writes the results in the requested format
+void WriteResults(std::ostream &_out, BenchmarkSettings &_settings, Map &_map, std::vector<BenchmarkResult> &_results)
+{
+	if(_settings.format == "csv")
+	{
+		_out << "map,seed,algo,heuristic,diagonals,queries,found,queries_per_second,mean_expansions,max_expansions,mean_ns,p50_ns,p90_ns,p99_ns,max_ns\n";
+
+		for(BenchmarkResult &result : _results)
+		{
+			_out << "\"" << _settings.mapFile << "\"," << _settings.seed << "," << GetAlgoName(result.algoType) << "," << result.heuristic << "," << (result.diagonals ? 1 : 0) << ","
+				<< result.numQueries << "," << result.numFound << "," << result.queriesPerSecond << "," << result.meanExpansions << "," << result.maxExpansions << ","
+				<< result.meanNanoseconds << "," << result.p50Nanoseconds << "," << result.p90Nanoseconds << "," << result.p99Nanoseconds << "," << result.maxNanoseconds << "\n";
+		}
+
+		return;
+	}
+
+	_out << "{\n";
+	_out << "  \"map\": \"" << _settings.mapFile << "\",\n";
+	_out << "  \"width\": " << _map.GetNumXTiles() << ",\n";
+	_out << "  \"height\": " << _map.GetNumYTiles() << ",\n";
+	_out << "  \"seed\": " << _settings.seed << ",\n";
+	_out << "  \"cache\": " << (_settings.useCache ? "true" : "false") << ",\n";
+	_out << "  \"node_budget_kb\": " << _settings.nodeBudgetKB << ",\n";
+	_out << "  \"results\": [\n";
+
+	for(unsigned int i = 0; i < _results.size(); i++)
+	{
+		BenchmarkResult &result = _results[i];
+
+		_out << "    { \"algo\": \"" << GetAlgoName(result.algoType) << "\", \"heuristic\": \"" << result.heuristic << "\", \"diagonals\": " << (result.diagonals ? "true" : "false")
+			<< ", \"queries\": " << result.numQueries << ", \"found\": " << result.numFound
+			<< ", \"queries_per_second\": " << result.queriesPerSecond << ", \"mean_expansions\": " << result.meanExpansions
+			<< ", \"max_expansions\": " << result.maxExpansions << ", \"mean_ns\": " << result.meanNanoseconds
+			<< ", \"p50_ns\": " << result.p50Nanoseconds << ", \"p90_ns\": " << result.p90Nanoseconds
+			<< ", \"p99_ns\": " << result.p99Nanoseconds << ", \"max_ns\": " << result.maxNanoseconds << " }"
+			<< (i + 1 < _results.size() ? "," : "") << "\n";
+	}
+
+	_out << "  ]\n";
+	_out << "}\n";
+}
+
+// Writes how many fewer or more nodes A Star expanded with the landmark heuristic than with the distance heuristic
+void ReportLandmarkSavings(std::ostream &_out, std::vector<BenchmarkResult> &_results)
+{
+	for(BenchmarkResult &octile : _results)
+	{
+		if(octile.heuristic != "octile")
+			continue;
+
+		for(BenchmarkResult &landmarks : _results)
+		{
+			if(landmarks.heuristic != "landmarks" || landmarks.diagonals != octile.diagonals || octile.meanExpansions <= 0.0)
+				continue;
+
+			double saving = 100.0 * (1.0 - landmarks.meanExpansions / octile.meanExpansions);
+
+			_out << "A Star with diagonals " << (octile.diagonals ? "on" : "off") << ": " << octile.meanExpansions << " expansions per query with the scaled distance heuristic, "
+				<< landmarks.meanExpansions << " with landmarks (" << std::abs(saving) << (saving >= 0.0 ? "% fewer)" : "% more)") << std::endl;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	BenchmarkSettings settings;
+
+	if(!ParseSettings(argc, argv, settings))
+	{
+		std::cerr << "Usage: Benchmark [map file] [--queries N] [--seed N] [--algos 0,1,...] [--format json|csv] [--output file] [--cache] [--node-budget KB]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream mapCheck(settings.mapFile);
+
+	if(!mapCheck.good())
+	{
+		std::cerr << "Could not open map file: " << settings.mapFile << std::endl;
+		return 1;
+	}
+
+	mapCheck.close();
+
+	Map map(c_benchMapWidth, c_benchMapHeight, settings.mapFile);
+	map.GetPathCache()->SetEnabled(settings.useCache);
+	map.SetChunkMemoryBudget((size_t)settings.nodeBudgetKB * 1024);
+
+	std::vector<glm::vec2> starts, ends;
+	GenerateQueries(map, settings.seed, settings.numQueries, starts, ends);
+
+	if(starts.empty())
+	{
+		std::cerr << "The map needs at least two traversable tiles" << std::endl;
+		return 1;
+	}
+
+	std::vector<BenchmarkResult> results;
+
+	// Runs each algorithm with diagonal movement on, as the map starts, and then off
+	for(int pass = 0; pass < 2; pass++)
+	{
+		for(int algoType : settings.algoTypes)
+		{
+			if(algoType == ALGO_A_STAR)
+			{
+				map.SetLandmarksEnabled(false);
+				results.push_back(RunQueries(map, algoType, starts, ends));
+				map.SetLandmarksEnabled(true);
+			}
+
+			results.push_back(RunQueries(map, algoType, starts, ends));
+		}
+
+		map.ToggleDiags();
+		map.UpdateEdgeList();
+	}
+
+	if(settings.outputFile.empty())
+		WriteResults(std::cout, settings, map, results);
+
+	else
+	{
+		std::ofstream outFile(settings.outputFile);
+		WriteResults(outFile, settings, map, results);
+	}
+
+	// The summary goes to the error stream so it doesn't get mixed into the results
+	ReportLandmarkSavings(std::cerr, results);
+
+	int exitCode = 0;
+
+	for(BenchmarkResult &result : results)
+	{
+		if(result.numDiagonalPaths > 0)
+		{
+			std::cerr << GetAlgoName(result.algoType) << " returned " << result.numDiagonalPaths << " paths with diagonal moves after they were turned off" << std::endl;
+			exitCode = 1;
+		}
+	}
+
+	return exitCode;
+}
\ No newline at end of file
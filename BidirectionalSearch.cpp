@@ -0,0 +1,143 @@
+#include "BidirectionalSearch.h"
+#include "Map.h"
+#include <limits>
+
+// Constructor - initialises member variables
+BidirectionalSearch::BidirectionalSearch(Map *_map) { m_map = _map; }
+
+// Destructor
+BidirectionalSearch::~BidirectionalSearch() {}
+
+// Searches from both ends until the cheapest path between them is known. Returns whether a path was found, in
+// which case the parents on the context lead from the end node back to the start
+bool BidirectionalSearch::FindPath(SearchContext &_context, int _openListType, int _startIndex, int _endIndex, bool _isPlayer, bool _useHeuristic, int &_numOps)
+{
+	SearchContext &backContext = *_context.GetSubContext();
+
+	backContext.BeginSearch(m_map->GetNumNodes());
+	backContext.SetBucketWidth(m_map->GetBucketWidth());
+
+	OpenList *forwardList = _context.GetOpenList(_openListType);
+	OpenList *backList = backContext.GetOpenList(_openListType);
+
+	// Starts the forward search at the start and the backward search at the end. The open lists are ordered by
+	// F cost for A Star and by G cost for Dijkstra, which is what the F cost is set to when there is no heuristic.
+	// Each side's heuristic is at the full distance between the ends where it starts, and the two heuristics
+	// always add up to that distance at every node, so it is added to the stopping cost
+	float heuristicSum = _useHeuristic ? Distance(_startIndex, _endIndex) : 0.0f;
+
+	_context.SetSearchState(_startIndex, NODE_OPEN);
+	_context.SetCosts(_startIndex, 0.0f, heuristicSum);
+	_context.SetParent(_startIndex, -1);
+	forwardList->Push(_startIndex, heuristicSum);
+
+	backContext.SetSearchState(_endIndex, NODE_OPEN);
+	backContext.SetCosts(_endIndex, 0.0f, heuristicSum);
+	backContext.SetParent(_endIndex, -1);
+	backList->Push(_endIndex, heuristicSum);
+
+	float bestCost = std::numeric_limits<float>::infinity();
+	int meetingIndex = -1;
+
+	while(!forwardList->IsEmpty() && !backList->IsEmpty())
+	{
+		float forwardCost = _context.GetFCost(forwardList->PeekLowest());
+		float backCost = backContext.GetFCost(backList->PeekLowest());
+
+		// Stops once no path joining the two sides can be cheaper than the best path found so far
+		if(forwardCost + backCost >= bestCost + heuristicSum)
+			break;
+
+		_numOps++;
+
+		if(forwardCost <= backCost)
+			ExpandNode(_context, backContext, forwardList, _endIndex, _startIndex, true, _isPlayer, _useHeuristic, bestCost, meetingIndex);
+		else
+			ExpandNode(backContext, _context, backList, _startIndex, _endIndex, false, _isPlayer, _useHeuristic, bestCost, meetingIndex);
+	}
+
+	if(meetingIndex == -1)
+		return false;
+
+	// The backward search's parents lead from the meeting node towards the end, so they are reversed onto the
+	// forward context to make one chain of parents from the end back to the start
+	int currIndex = meetingIndex;
+	int nextIndex = backContext.GetParent(currIndex);
+
+	while(nextIndex != -1)
+	{
+		_context.SetParent(nextIndex, currIndex);
+
+		currIndex = nextIndex;
+		nextIndex = backContext.GetParent(currIndex);
+	}
+
+	return true;
+}
+
+// Closes the cheapest node on one side and updates its neighbours. Whenever a neighbour has already been
+// reached by the other side the cost of the path through it is checked against the best one found
+void BidirectionalSearch::ExpandNode(SearchContext &_context, SearchContext &_otherContext, OpenList *_openList, int _targetIndex, int _sourceIndex, bool _forward, bool _isPlayer, bool _useHeuristic, float &_bestCost, int &_meetingIndex)
+{
+	int currIndex = _openList->PopLowest();
+
+	_context.SetSearchState(currIndex, NODE_CLOSED);
+
+	unsigned char neighbourMask = m_map->GetNeighbourMask(currIndex);
+	float currGCost = _context.GetGCost(currIndex);
+
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+	{
+		if(!(neighbourMask & (1 << dir)))
+			continue;
+
+		int neighbourIndex = m_map->GetNeighbourIndex(currIndex, dir);
+		int neighbourState = _context.GetSearchState(neighbourIndex);
+
+		if(neighbourState == NODE_CLOSED)
+			continue;
+
+		// Neighbour masks only link traversable nodes so every link goes both ways, but the backward search is
+		// following the move from the neighbour to the current node
+		float moveCost = _forward ? m_map->GetMoveCost(currIndex, neighbourIndex, _isPlayer) : m_map->GetMoveCost(neighbourIndex, currIndex, _isPlayer);
+		float tempGCost = currGCost + moveCost;
+
+		if(neighbourState == NODE_OPEN && tempGCost >= _context.GetGCost(neighbourIndex))
+			continue;
+
+		float tempFCost = tempGCost + (_useHeuristic ? Heuristic(neighbourIndex, _targetIndex, _sourceIndex) : 0.0f);
+
+		_context.SetCosts(neighbourIndex, tempGCost, tempFCost);
+		_context.SetParent(neighbourIndex, currIndex);
+
+		if(neighbourState == NODE_OPEN)
+			_openList->DecreaseKey(neighbourIndex, tempFCost);
+
+		else
+		{
+			_context.SetSearchState(neighbourIndex, NODE_OPEN);
+			_openList->Push(neighbourIndex, tempFCost);
+		}
+
+		if(_otherContext.GetSearchState(neighbourIndex) != NODE_UNVISITED && tempGCost + _otherContext.GetGCost(neighbourIndex) < _bestCost)
+		{
+			_bestCost = tempGCost + _otherContext.GetGCost(neighbourIndex);
+			_meetingIndex = neighbourIndex;
+		}
+	}
+}
+
+// Returns the heuristic for a node on the side searching from the source towards the target. It is half of the
+// estimate to the target minus the estimate to the source, moved up by half the estimate between the two ends
+// so it is never negative. Each step changes it by no more than the step costs, so nodes are still closed with
+// their cheapest cost
+float BidirectionalSearch::Heuristic(int _nodeIndex, int _targetIndex, int _sourceIndex)
+{
+	return (Distance(_nodeIndex, _targetIndex) - Distance(_nodeIndex, _sourceIndex) + Distance(_targetIndex, _sourceIndex)) * 0.5f;
+}
+
+// Returns an estimate of the cost between two nodes that is never more than the real cost
+float BidirectionalSearch::Distance(int _first, int _second)
+{
+	return m_map->DistBetweenNodes(m_map->GetNode(_first), m_map->GetNode(_second)) * c_minCostPerDistance;
+}
\ No newline at end of file
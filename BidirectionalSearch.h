@@ -0,0 +1,36 @@
+#ifndef BIDIRECTIONALSEARCH_H
+#define BIDIRECTIONALSEARCH_H
+
+#include "SearchContext.h"
+
+class Map;
+
+// Bidirectional A Star and Dijkstra over the map. One search runs forward from the start on the given context
+// and a second runs backward from the end on its sub-context, always expanding whichever side has the cheaper
+// node at the top of its open list. Moves cost different amounts in each direction because half of the cost
+// comes from the tile being left, so the backward search costs each move from the neighbour to the node being
+// expanded, exactly as the forward search would.
+//
+// Every time a node is reached by one side that the other has already reached, the cost through it is
+// compared with the cheapest path found so far, and the search stops once the two cheapest costs on the open
+// lists add up to at least that cost. For A Star each side uses half the difference between the estimates to
+// its own target and to the other side's target (the estimates are scaled down so they never overestimate).
+// The two sides then agree on which nodes are promising and the same stopping rule as Dijkstra's still holds
+class BidirectionalSearch
+{
+	public:
+		// Constructor and destructor
+		BidirectionalSearch(Map *_map);
+		~BidirectionalSearch();
+
+		bool FindPath(SearchContext &_context, int _openListType, int _startIndex, int _endIndex, bool _isPlayer, bool _useHeuristic, int &_numOps);
+
+	private:
+		void ExpandNode(SearchContext &_context, SearchContext &_otherContext, OpenList *_openList, int _targetIndex, int _sourceIndex, bool _forward, bool _isPlayer, bool _useHeuristic, float &_bestCost, int &_meetingIndex);
+		float Heuristic(int _nodeIndex, int _targetIndex, int _sourceIndex);
+		float Distance(int _first, int _second);
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
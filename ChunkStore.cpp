@@ -0,0 +1,168 @@
+#include "ChunkStore.h"
+#include "MapFile.h"
+#include <algorithm>
+
+// Constructor - initialises member variables. Takes ownership of the map file if there is one, otherwise the
+// tile types are moved out of the given list. No chunks are loaded until they are used
+ChunkStore::ChunkStore(int _numXTiles, int _numYTiles, float _tileWidth, float _tileHeight, MapFile *_mapFile, std::vector<int> &_tileTypes)
+{
+	m_numXTiles = _numXTiles;
+	m_numYTiles = _numYTiles;
+	m_numXChunks = (_numXTiles + c_chunkMask) >> c_chunkShift;
+	m_numYChunks = (_numYTiles + c_chunkMask) >> c_chunkShift;
+	m_tileWidth = _tileWidth;
+	m_tileHeight = _tileHeight;
+
+	m_mapFile.reset(_mapFile);
+	m_tileTypes.swap(_tileTypes);
+
+	m_chunks.reset(new NodeChunk[GetNumChunks()]);
+	m_savedNodes.resize(GetNumChunks());
+
+	for(int i = 0; i < GetNumChunks(); i++)
+	{
+		m_chunks[i].nodes = nullptr;
+		m_chunks[i].referenced = false;
+	}
+
+	m_numLoaded = 0;
+	m_maxLoaded = 0;
+	m_clockHand = 0;
+}
+
+// Destructor - deletes the nodes of every loaded chunk
+ChunkStore::~ChunkStore()
+{
+	for(int i = 0; i < GetNumChunks(); i++)
+		delete[] m_chunks[i].nodes.load();
+}
+
+// Getters
+
+int ChunkStore::GetNumChunks() { return m_numXChunks * m_numYChunks; }
+int ChunkStore::GetNumLoadedChunks() { return m_numLoaded; }
+
+// Returns how much memory the nodes of one chunk take up
+size_t ChunkStore::GetChunkBytes() { return c_chunkNodes * sizeof(Node); }
+
+// Returns whether the tile can be walked on. If its chunk isn't loaded and none of its nodes were changed, the
+// tile type is read from the map file instead of loading the chunk, so the map can check every tile without
+// loading them all. Tile type 3 is a wall. Like TrimToBudget this must not be called while a search is running
+bool ChunkStore::IsTraversable(int _nodeIndex)
+{
+	int tileY = _nodeIndex / m_numXTiles;
+	int tileX = _nodeIndex - tileY * m_numXTiles;
+	int chunkIndex = (tileY >> c_chunkShift) * m_numXChunks + (tileX >> c_chunkShift);
+
+	if(m_chunks[chunkIndex].nodes.load(std::memory_order_acquire) == nullptr && m_savedNodes[chunkIndex].empty())
+		return (m_mapFile ? m_mapFile->GetTileType(_nodeIndex) : m_tileTypes[_nodeIndex]) != 3;
+
+	return GetNode(_nodeIndex).IsTraversable();
+}
+
+// Setters
+
+// Sets how much memory the loaded chunks can take up. A budget of zero keeps every chunk loaded once it has
+// been used. At least one chunk is always allowed
+void ChunkStore::SetMemoryBudget(size_t _bytes)
+{
+	m_maxLoaded = 0;
+
+	if(_bytes > 0)
+		m_maxLoaded = std::max<size_t>(_bytes / GetChunkBytes(), 1);
+}
+
+// Unloads chunks until the loaded chunks fit in the memory budget. A clock sweep picks which ones: a chunk that
+// has been used since the hand last passed it has its flag cleared and is skipped, and the first one that
+// hasn't is unloaded
+void ChunkStore::TrimToBudget()
+{
+	if(m_maxLoaded == 0)
+		return;
+
+	while(m_numLoaded > m_maxLoaded)
+	{
+		NodeChunk &chunk = m_chunks[m_clockHand];
+
+		if(chunk.nodes.load() != nullptr)
+		{
+			if(chunk.referenced)
+				chunk.referenced = false;
+
+			else
+				UnloadChunk(m_clockHand);
+		}
+
+		m_clockHand = (m_clockHand + 1) % GetNumChunks();
+	}
+}
+
+// Creates the nodes of a chunk from the map file and puts back any of them that were changed before it was
+// last unloaded. Returns the chunk's nodes, which another thread may have loaded first
+Node* ChunkStore::LoadChunk(int _chunkIndex)
+{
+	std::lock_guard<std::mutex> lock(m_loadMutex);
+
+	NodeChunk &chunk = m_chunks[_chunkIndex];
+	Node *nodes = chunk.nodes.load(std::memory_order_relaxed);
+
+	if(nodes != nullptr)
+		return nodes;
+
+	nodes = new Node[c_chunkNodes];
+
+	int startX = (_chunkIndex % m_numXChunks) << c_chunkShift;
+	int startY = (_chunkIndex / m_numXChunks) << c_chunkShift;
+	int endX = std::min(startX + c_chunkSize, m_numXTiles);
+	int endY = std::min(startY + c_chunkSize, m_numYTiles);
+
+	for(int y = startY; y < endY; y++)
+	{
+		for(int x = startX; x < endX; x++)
+		{
+			int nodeIndex = y * m_numXTiles + x;
+			int tileType = m_mapFile ? m_mapFile->GetTileType(nodeIndex) : m_tileTypes[nodeIndex];
+
+			nodes[((y - startY) << c_chunkShift) + (x - startX)].CreateNode(nodeIndex, tileType, x * m_tileWidth + m_tileWidth * 0.5, y * m_tileHeight + m_tileHeight * 0.5, m_numXTiles);
+		}
+	}
+
+	for(Node &node : m_savedNodes[_chunkIndex])
+		nodes[((node.GetTileY() - startY) << c_chunkShift) + (node.GetTileX() - startX)] = node;
+
+	m_savedNodes[_chunkIndex].clear();
+	m_numLoaded++;
+
+	chunk.nodes.store(nodes, std::memory_order_release);
+
+	return nodes;
+}
+
+// Keeps the nodes of the chunk that have changed since the map was loaded and deletes the rest
+void ChunkStore::UnloadChunk(int _chunkIndex)
+{
+	NodeChunk &chunk = m_chunks[_chunkIndex];
+	Node *nodes = chunk.nodes.load();
+
+	int startX = (_chunkIndex % m_numXChunks) << c_chunkShift;
+	int startY = (_chunkIndex / m_numXChunks) << c_chunkShift;
+	int endX = std::min(startX + c_chunkSize, m_numXTiles);
+	int endY = std::min(startY + c_chunkSize, m_numYTiles);
+
+	for(int y = 0; y < endY - startY; y++)
+	{
+		for(int x = 0; x < endX - startX; x++)
+		{
+			Node &node = nodes[(y << c_chunkShift) + x];
+
+			if(node.HasChangedSince(0))
+				m_savedNodes[_chunkIndex].push_back(node);
+		}
+	}
+
+	delete[] nodes;
+
+	chunk.nodes = nullptr;
+	chunk.referenced = false;
+	m_numLoaded--;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef CHUNKSTORE_H
+#define CHUNKSTORE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include "Node.h"
+
+class MapFile;
+
+// Chunks are square blocks of tiles with a side length of two to the power of this
+const int c_chunkShift = 5;
+const int c_chunkSize = 1 << c_chunkShift;
+const int c_chunkMask = c_chunkSize - 1;
+const int c_chunkNodes = c_chunkSize * c_chunkSize;
+
+// Nodes of one chunk, which are only created while the chunk is loaded
+struct NodeChunk
+{
+	std::atomic<Node*> nodes;
+	std::atomic<bool> referenced;
+};
+
+// Holds the nodes of a map split into square chunks. A chunk's nodes are created from the map file the first
+// time one of them is asked for, so a search or entity only loads the parts of the world it touches. Once more
+// chunks are loaded than the memory budget allows, the chunks that haven't been used recently are unloaded
+// and only their changed nodes are kept. Chunks are only unloaded by TrimToBudget, which must not be called
+// while a search is running or a node reference is held, so any number of threads can load chunks at once.
+//
+// Only the nodes are paged. The changed nodes of an unloaded chunk are kept in memory rather than written back
+// to the map file, so the memory they use grows with the number of tiles edited. The map's per-tile tables stay
+// whole: the neighbour masks, the occupancy layer and each search context's per-tile state are allocated for the
+// whole map, and the jump tables, cluster graph, connected components and landmarks are too once something
+// first uses them
+class ChunkStore
+{
+	public:
+		// Constructor and destructor
+		ChunkStore(int _numXTiles, int _numYTiles, float _tileWidth, float _tileHeight, MapFile *_mapFile, std::vector<int> &_tileTypes);
+		~ChunkStore();
+
+		// Getters
+		int GetNumChunks();
+		int GetNumLoadedChunks();
+		size_t GetChunkBytes();
+		bool IsTraversable(int _nodeIndex);
+
+		// Returns the node at the given index, loading its chunk if it isn't loaded
+		Node& GetNode(int _nodeIndex)
+		{
+			int tileY = _nodeIndex / m_numXTiles;
+			int tileX = _nodeIndex - tileY * m_numXTiles;
+			int chunkIndex = (tileY >> c_chunkShift) * m_numXChunks + (tileX >> c_chunkShift);
+
+			NodeChunk &chunk = m_chunks[chunkIndex];
+			Node *nodes = chunk.nodes.load(std::memory_order_acquire);
+
+			if(nodes == nullptr)
+				nodes = LoadChunk(chunkIndex);
+
+			// Only written when it changes so threads reading the same chunk don't keep writing to it
+			if(!chunk.referenced.load(std::memory_order_relaxed))
+				chunk.referenced.store(true, std::memory_order_relaxed);
+
+			return nodes[((tileY & c_chunkMask) << c_chunkShift) + (tileX & c_chunkMask)];
+		}
+
+		// Setters
+		void SetMemoryBudget(size_t _bytes);
+
+		void TrimToBudget();
+
+	private:
+		Node* LoadChunk(int _chunkIndex);
+		void UnloadChunk(int _chunkIndex);
+
+		int m_numXTiles, m_numYTiles;
+		int m_numXChunks, m_numYChunks;
+		float m_tileWidth, m_tileHeight;
+
+		// Where the tile types come from, either the mapped binary map or the tiles read from a text map
+		std::unique_ptr<MapFile> m_mapFile;
+		std::vector<int> m_tileTypes;
+
+		std::unique_ptr<NodeChunk[]> m_chunks;
+		std::vector<std::vector<Node>> m_savedNodes;
+
+		int m_numLoaded;
+		int m_maxLoaded;
+		int m_clockHand;
+
+		std::mutex m_loadMutex;
+};
+
+#endif
\ No newline at end of file
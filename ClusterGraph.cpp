@@ -0,0 +1,516 @@
+#include "ClusterGraph.h"
+#include "Map.h"
+#include <algorithm>
+
+// Border openings shorter than this get a single entrance in the middle, longer ones get one at each end
+static const int c_maxSingleEntranceLength = 6;
+
+// Constructor - initialises member variables and builds the graph for the map
+ClusterGraph::ClusterGraph(Map *_map)
+{
+	m_map = _map;
+
+	RebuildGraph();
+}
+
+// Destructor
+ClusterGraph::~ClusterGraph() {}
+
+// Getters
+
+// Returns whether diagonal movement was allowed when the cluster costs were calculated
+bool ClusterGraph::BuiltWithDiags() { return m_builtWithDiags; }
+
+// Finds a path by searching the graph of cluster entrances and then searching inside each cluster along the
+// way to fill in the tiles between them. Returns whether a path was found, in which case the parents on the
+// context lead from the end node back to the start one tile at a time
+bool ClusterGraph::FindPath(SearchContext &_context, int _startIndex, int _endIndex, bool _isPlayer, int &_numOps)
+{
+	SearchContext &clusterContext = *_context.GetSubContext();
+
+	int startCluster = GetClusterIndex(_startIndex);
+	int endCluster = GetClusterIndex(_endIndex);
+	Cluster &start = m_clusters[startCluster];
+	Cluster &end = m_clusters[endCluster];
+
+	std::vector<float> startCosts(start.entrances.size(), -1.0f);
+	std::vector<float> endCosts(end.entrances.size(), -1.0f);
+	float directCost = -1.0f;
+
+	// Finds the cost from the start to every entrance of its cluster, and directly to the end if it is in the same cluster
+	SearchCluster(clusterContext, startCluster, _startIndex, -1, _isPlayer, false, _numOps);
+
+	for(unsigned int i = 0; i < start.entrances.size(); i++)
+	{
+		if(clusterContext.GetSearchState(start.entrances[i]) == NODE_CLOSED)
+			startCosts[i] = clusterContext.GetGCost(start.entrances[i]);
+	}
+
+	if(startCluster == endCluster && clusterContext.GetSearchState(_endIndex) == NODE_CLOSED)
+		directCost = clusterContext.GetGCost(_endIndex);
+
+	// Finds the cost from every entrance of the end cluster to the end
+	SearchCluster(clusterContext, endCluster, _endIndex, -1, _isPlayer, true, _numOps);
+
+	for(unsigned int i = 0; i < end.entrances.size(); i++)
+	{
+		if(clusterContext.GetSearchState(end.entrances[i]) == NODE_CLOSED)
+			endCosts[i] = clusterContext.GetGCost(end.entrances[i]);
+	}
+
+	// Runs A Star over the entrances. The start and end only link to the entrances of their own clusters
+	OpenList *openList = _context.GetOpenList(OPEN_LIST_BINARY_HEAP);
+
+	_context.SetSearchState(_startIndex, NODE_OPEN);
+	_context.SetCosts(_startIndex, 0.0f, Distance(_startIndex, _endIndex));
+	_context.SetParent(_startIndex, -1);
+	openList->Push(_startIndex, _context.GetFCost(_startIndex));
+
+	bool pathFound = false;
+
+	while(!openList->IsEmpty())
+	{
+		int currIndex = openList->PopLowest();
+		float currGCost = _context.GetGCost(currIndex);
+
+		_context.SetSearchState(currIndex, NODE_CLOSED);
+
+		_numOps++;
+
+		if(currIndex == _endIndex)
+		{
+			pathFound = true;
+			break;
+		}
+
+		if(currIndex == _startIndex)
+		{
+			for(unsigned int i = 0; i < start.entrances.size(); i++)
+			{
+				if(startCosts[i] >= 0.0f)
+					RelaxNode(_context, openList, currIndex, start.entrances[i], startCosts[i], _endIndex);
+			}
+
+			if(directCost >= 0.0f)
+				RelaxNode(_context, openList, currIndex, _endIndex, directCost, _endIndex);
+		}
+
+		int slot = m_entranceSlots[currIndex];
+
+		if(slot == -1)
+			continue;
+
+		// Moves to the other entrances of the same cluster using the cached costs, across the links to
+		// neighbouring clusters and to the end if this is the end cluster
+		int clusterIndex = GetClusterIndex(currIndex);
+		Cluster &cluster = m_clusters[clusterIndex];
+		std::vector<float> &costs = _isPlayer ? cluster.playerCosts : cluster.enemyCosts;
+		int numEntrances = cluster.entrances.size();
+
+		for(int i = 0; i < numEntrances; i++)
+		{
+			if(costs[slot * numEntrances + i] >= 0.0f)
+				RelaxNode(_context, openList, currIndex, cluster.entrances[i], currGCost + costs[slot * numEntrances + i], _endIndex);
+		}
+
+		for(ClusterLink &link : cluster.links)
+		{
+			if(link.tileIndex == currIndex)
+				RelaxNode(_context, openList, currIndex, link.acrossIndex, currGCost + m_map->GetMoveCost(currIndex, link.acrossIndex, _isPlayer), _endIndex);
+		}
+
+		if(clusterIndex == endCluster && endCosts[slot] >= 0.0f)
+			RelaxNode(_context, openList, currIndex, _endIndex, currGCost + endCosts[slot], _endIndex);
+	}
+
+	if(!pathFound)
+		return false;
+
+	std::vector<int> abstractPath;
+
+	for(int n = _endIndex; n != -1; n = _context.GetParent(n))
+		abstractPath.push_back(n);
+
+	std::reverse(abstractPath.begin(), abstractPath.end());
+
+	// Fills in the tiles between each pair of entrances. Pairs in different clusters are either side of a link
+	// so are next to each other, otherwise the path between them is found by searching their cluster
+	std::vector<int> tiles;
+	tiles.push_back(_startIndex);
+
+	for(unsigned int i = 1; i < abstractPath.size(); i++)
+	{
+		int from = abstractPath[i-1];
+		int to = abstractPath[i];
+
+		if(GetClusterIndex(from) != GetClusterIndex(to))
+		{
+			tiles.push_back(to);
+			continue;
+		}
+
+		SearchCluster(clusterContext, GetClusterIndex(from), from, to, _isPlayer, false, _numOps);
+
+		int segmentStart = tiles.size();
+
+		for(int n = to; n != from; n = clusterContext.GetParent(n))
+			tiles.push_back(n);
+
+		std::reverse(tiles.begin() + segmentStart, tiles.end());
+	}
+
+	// Stores the tiles as a chain of parents on the context. If the path comes back to a tile it has already
+	// passed through the loop between the two visits is cut out, which can only make the path cheaper
+	_context.BeginSearch(m_numXTiles * m_numYTiles);
+
+	std::vector<int> finalTiles;
+
+	for(int tile : tiles)
+	{
+		if(_context.GetSearchState(tile) == NODE_CLOSED)
+		{
+			while(finalTiles.back() != tile)
+			{
+				_context.SetSearchState(finalTiles.back(), NODE_UNVISITED);
+				finalTiles.pop_back();
+			}
+
+			continue;
+		}
+
+		_context.SetSearchState(tile, NODE_CLOSED);
+		_context.SetParent(tile, finalTiles.empty() ? -1 : finalTiles.back());
+		finalTiles.push_back(tile);
+	}
+
+	return true;
+}
+
+// Rebuilds the links, entrances and costs of every cluster on the map
+void ClusterGraph::RebuildGraph()
+{
+	m_builtWithDiags = m_map->DiagsAllowed();
+
+	m_numXTiles = m_map->GetNumXTiles();
+	m_numYTiles = m_map->GetNumYTiles();
+	m_numXClusters = (m_numXTiles + c_clusterSize - 1) / c_clusterSize;
+	m_numYClusters = (m_numYTiles + c_clusterSize - 1) / c_clusterSize;
+
+	m_clusters.assign(m_numXClusters * m_numYClusters, Cluster());
+	m_entranceSlots.assign(m_numXTiles * m_numYTiles, -1);
+
+	for(int y = 0; y < m_numYClusters; y++)
+	{
+		for(int x = 0; x < m_numXClusters; x++)
+		{
+			if(x + 1 < m_numXClusters)
+				UpdateBorder(y * m_numXClusters + x, y * m_numXClusters + x + 1);
+
+			if(y + 1 < m_numYClusters)
+				UpdateBorder(y * m_numXClusters + x, (y + 1) * m_numXClusters + x);
+		}
+	}
+
+	for(unsigned int c = 0; c < m_clusters.size(); c++)
+	{
+		UpdateEntrances(c);
+		UpdateClusterCosts(c);
+	}
+}
+
+// Updates the cluster containing a changed tile. If the tile can now be walked on when it couldn't before, or
+// the other way round, and it sits on the edge of its cluster, the links across that edge and the neighbouring
+// cluster's entrances are rebuilt as well
+void ClusterGraph::UpdateTile(int _tileX, int _tileY, bool _traversabilityChanged)
+{
+	int clusterX = _tileX / c_clusterSize;
+	int clusterY = _tileY / c_clusterSize;
+	int clusterIndex = clusterY * m_numXClusters + clusterX;
+
+	if(_traversabilityChanged)
+	{
+		int localX = _tileX % c_clusterSize;
+		int localY = _tileY % c_clusterSize;
+		int neighbours[4] = { -1, -1, -1, -1 };
+
+		if(localX == 0 && clusterX > 0)
+			neighbours[0] = clusterIndex - 1;
+
+		if(localX == c_clusterSize - 1 && clusterX + 1 < m_numXClusters)
+			neighbours[1] = clusterIndex + 1;
+
+		if(localY == 0 && clusterY > 0)
+			neighbours[2] = clusterIndex - m_numXClusters;
+
+		if(localY == c_clusterSize - 1 && clusterY + 1 < m_numYClusters)
+			neighbours[3] = clusterIndex + m_numXClusters;
+
+		for(int n = 0; n < 4; n++)
+		{
+			if(neighbours[n] == -1)
+				continue;
+
+			UpdateBorder(min(clusterIndex, neighbours[n]), max(clusterIndex, neighbours[n]));
+			UpdateEntrances(neighbours[n]);
+			UpdateClusterCosts(neighbours[n]);
+		}
+
+		UpdateEntrances(clusterIndex);
+	}
+
+	UpdateClusterCosts(clusterIndex);
+}
+
+// Recalculates the costs of every cluster that overlaps the given area of tiles. Used when costs in the area
+// have changed without any tile becoming blocked or unblocked, so the entrances stay the same
+void ClusterGraph::UpdateArea(int _minX, int _minY, int _maxX, int _maxY)
+{
+	int minClusterX = max(_minX, 0) / c_clusterSize;
+	int minClusterY = max(_minY, 0) / c_clusterSize;
+	int maxClusterX = min(_maxX, m_numXTiles - 1) / c_clusterSize;
+	int maxClusterY = min(_maxY, m_numYTiles - 1) / c_clusterSize;
+
+	for(int y = minClusterY; y <= maxClusterY; y++)
+	{
+		for(int x = minClusterX; x <= maxClusterX; x++)
+			UpdateClusterCosts(y * m_numXClusters + x);
+	}
+}
+
+// Returns the index of the cluster the node is in
+int ClusterGraph::GetClusterIndex(int _nodeIndex)
+{
+	return ((_nodeIndex / m_numXTiles) / c_clusterSize) * m_numXClusters + (_nodeIndex % m_numXTiles) / c_clusterSize;
+}
+
+bool ClusterGraph::InCluster(int _nodeIndex, int _clusterIndex) { return GetClusterIndex(_nodeIndex) == _clusterIndex; }
+
+// Returns an estimate of the cost between two nodes that is never more than the real cost
+float ClusterGraph::Distance(int _first, int _second)
+{
+	return m_map->DistBetweenNodes(m_map->GetNode(_first), m_map->GetNode(_second)) * c_minCostPerDistance;
+}
+
+// Rebuilds the links across the border between two neighbouring clusters. The first cluster must be to the
+// left of or above the second. Each run of tiles that can be crossed gets one link in its middle, or one at
+// each end if it is long
+void ClusterGraph::UpdateBorder(int _first, int _second)
+{
+	Cluster &first = m_clusters[_first];
+	Cluster &second = m_clusters[_second];
+
+	// Removes the old links between the two clusters
+	for(int c = 0; c < 2; c++)
+	{
+		Cluster &cluster = (c == 0) ? first : second;
+		int other = (c == 0) ? _second : _first;
+
+		for(unsigned int i = 0; i < cluster.links.size();)
+		{
+			if(InCluster(cluster.links[i].acrossIndex, other))
+			{
+				cluster.links[i] = cluster.links.back();
+				cluster.links.pop_back();
+			}
+			else
+				i++;
+		}
+	}
+
+	// Works out the tiles either side of the border and which way to step along it
+	bool horizontal = (_second == _first + 1);
+	int firstX = (_first % m_numXClusters) * c_clusterSize;
+	int firstY = (_first / m_numXClusters) * c_clusterSize;
+	int borderStart, acrossOffset, step, length;
+
+	if(horizontal)
+	{
+		borderStart = firstY * m_numXTiles + firstX + c_clusterSize - 1;
+		acrossOffset = 1;
+		step = m_numXTiles;
+		length = min(c_clusterSize, m_numYTiles - firstY);
+	}
+	else
+	{
+		borderStart = (firstY + c_clusterSize - 1) * m_numXTiles + firstX;
+		acrossOffset = m_numXTiles;
+		step = 1;
+		length = min(c_clusterSize, m_numXTiles - firstX);
+	}
+
+	int runStart = -1;
+
+	for(int i = 0; i <= length; i++)
+	{
+		int tile = borderStart + i * step;
+		bool open = (i < length) && m_map->GetNode(tile).IsTraversable() && m_map->GetNode(tile + acrossOffset).IsTraversable();
+
+		if(open && runStart == -1)
+			runStart = i;
+
+		if(!open && runStart != -1)
+		{
+			int runLength = i - runStart;
+			int positions[2] = { runStart + runLength / 2, -1 };
+
+			if(runLength >= c_maxSingleEntranceLength)
+			{
+				positions[0] = runStart;
+				positions[1] = i - 1;
+			}
+
+			for(int p = 0; p < 2; p++)
+			{
+				if(positions[p] == -1)
+					continue;
+
+				int linkTile = borderStart + positions[p] * step;
+				ClusterLink forward = { linkTile, linkTile + acrossOffset };
+				ClusterLink backward = { linkTile + acrossOffset, linkTile };
+
+				first.links.push_back(forward);
+				second.links.push_back(backward);
+			}
+
+			runStart = -1;
+		}
+	}
+}
+
+// Rebuilds the list of entrances of a cluster from its links
+void ClusterGraph::UpdateEntrances(int _clusterIndex)
+{
+	Cluster &cluster = m_clusters[_clusterIndex];
+
+	for(int tile : cluster.entrances)
+		m_entranceSlots[tile] = -1;
+
+	cluster.entrances.clear();
+
+	for(ClusterLink &link : cluster.links)
+	{
+		if(m_entranceSlots[link.tileIndex] == -1)
+		{
+			m_entranceSlots[link.tileIndex] = cluster.entrances.size();
+			cluster.entrances.push_back(link.tileIndex);
+		}
+	}
+}
+
+// Recalculates the cost of moving between every pair of entrances of a cluster without leaving it, for both
+// players and enemies. Pairs that cannot reach each other inside the cluster are given a cost of -1
+void ClusterGraph::UpdateClusterCosts(int _clusterIndex)
+{
+	Cluster &cluster = m_clusters[_clusterIndex];
+	int numEntrances = cluster.entrances.size();
+	int numOps = 0;
+
+	cluster.playerCosts.assign(numEntrances * numEntrances, -1.0f);
+	cluster.enemyCosts.assign(numEntrances * numEntrances, -1.0f);
+
+	for(int i = 0; i < numEntrances; i++)
+	{
+		for(int p = 0; p < 2; p++)
+		{
+			std::vector<float> &costs = (p == 0) ? cluster.enemyCosts : cluster.playerCosts;
+
+			SearchCluster(m_buildContext, _clusterIndex, cluster.entrances[i], -1, p == 1, false, numOps);
+
+			for(int j = 0; j < numEntrances; j++)
+			{
+				if(m_buildContext.GetSearchState(cluster.entrances[j]) == NODE_CLOSED)
+					costs[i * numEntrances + j] = m_buildContext.GetGCost(cluster.entrances[j]);
+			}
+		}
+	}
+}
+
+// Updates the cost of a node reached during the entrance search and adds it to the open list if it is cheaper
+// than any way found to it before
+void ClusterGraph::RelaxNode(SearchContext &_context, OpenList *_openList, int _parentIndex, int _nodeIndex, float _gCost, int _endIndex)
+{
+	int state = _context.GetSearchState(_nodeIndex);
+
+	if(state == NODE_CLOSED || (state == NODE_OPEN && _gCost >= _context.GetGCost(_nodeIndex)))
+		return;
+
+	float fCost = _gCost + Distance(_nodeIndex, _endIndex);
+
+	_context.SetCosts(_nodeIndex, _gCost, fCost);
+	_context.SetParent(_nodeIndex, _parentIndex);
+
+	if(state == NODE_OPEN)
+		_openList->DecreaseKey(_nodeIndex, fCost);
+
+	else
+	{
+		_context.SetSearchState(_nodeIndex, NODE_OPEN);
+		_openList->Push(_nodeIndex, fCost);
+	}
+}
+
+// Runs Dijkstra's algorithm from a node without leaving its cluster. If a target node is given the search stops
+// when it is reached and its cost is returned, or -1 if it can't be reached. Otherwise every node in the cluster
+// that can be reached is closed with its cost. A reverse search finds the cost of moving from each node to the
+// given node instead
+float ClusterGraph::SearchCluster(SearchContext &_context, int _clusterIndex, int _fromIndex, int _toIndex, bool _isPlayer, bool _reverse, int &_numOps)
+{
+	_context.BeginSearch(m_numXTiles * m_numYTiles);
+
+	OpenList *openList = _context.GetOpenList(OPEN_LIST_BINARY_HEAP);
+
+	_context.SetSearchState(_fromIndex, NODE_OPEN);
+	_context.SetCosts(_fromIndex, 0.0f, 0.0f);
+	_context.SetParent(_fromIndex, -1);
+	openList->Push(_fromIndex, 0.0f);
+
+	while(!openList->IsEmpty())
+	{
+		int currIndex = openList->PopLowest();
+		float currGCost = _context.GetGCost(currIndex);
+
+		_context.SetSearchState(currIndex, NODE_CLOSED);
+
+		_numOps++;
+
+		if(currIndex == _toIndex)
+			return currGCost;
+
+		unsigned char neighbourMask = m_map->GetNeighbourMask(currIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = m_map->GetNeighbourIndex(currIndex, dir);
+
+			if(!InCluster(neighbourIndex, _clusterIndex))
+				continue;
+
+			int state = _context.GetSearchState(neighbourIndex);
+
+			if(state == NODE_CLOSED)
+				continue;
+
+			float gCost = currGCost + (_reverse ? m_map->GetMoveCost(neighbourIndex, currIndex, _isPlayer) : m_map->GetMoveCost(currIndex, neighbourIndex, _isPlayer));
+
+			if(state == NODE_OPEN && gCost >= _context.GetGCost(neighbourIndex))
+				continue;
+
+			_context.SetCosts(neighbourIndex, gCost, gCost);
+			_context.SetParent(neighbourIndex, currIndex);
+
+			if(state == NODE_OPEN)
+				openList->DecreaseKey(neighbourIndex, gCost);
+
+			else
+			{
+				_context.SetSearchState(neighbourIndex, NODE_OPEN);
+				openList->Push(neighbourIndex, gCost);
+			}
+		}
+	}
+
+	return (_toIndex == -1) ? 0.0f : -1.0f;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef CLUSTERGRAPH_H
+#define CLUSTERGRAPH_H
+
+#include <vector>
+#include "SearchContext.h"
+
+class Map;
+
+// Size in tiles of each side of a cluster
+const int c_clusterSize = 10;
+
+// Pair of traversable tiles either side of the border between two clusters that a path can cross between
+struct ClusterLink
+{
+	int tileIndex;
+	int acrossIndex;
+};
+
+// A square block of tiles in the cluster graph. Entrances are the tiles of the cluster that have a link to
+// a neighbouring cluster. The cheapest cost of moving between every pair of entrances without leaving the
+// cluster is cached for both players and enemies
+struct Cluster
+{
+	std::vector<ClusterLink> links;
+	std::vector<int> entrances;
+	std::vector<float> playerCosts;
+	std::vector<float> enemyCosts;
+};
+
+// Hierarchical pathfinding (HPA*) layer built on top of the map grid. A long query searches the small graph
+// of cluster entrances and then only searches inside each cluster along the way to fill in the tiles. When a
+// tile changes only the cluster it is in, and the neighbours sharing a border with it when the border
+// changes, are rebuilt
+class ClusterGraph
+{
+	public:
+		// Constructor and destructor
+		ClusterGraph(Map *_map);
+		~ClusterGraph();
+
+		// Getters
+		bool BuiltWithDiags();
+
+		bool FindPath(SearchContext &_context, int _startIndex, int _endIndex, bool _isPlayer, int &_numOps);
+
+		void RebuildGraph();
+		void UpdateTile(int _tileX, int _tileY, bool _traversabilityChanged);
+		void UpdateArea(int _minX, int _minY, int _maxX, int _maxY);
+
+	private:
+		int GetClusterIndex(int _nodeIndex);
+		bool InCluster(int _nodeIndex, int _clusterIndex);
+		float Distance(int _first, int _second);
+
+		void UpdateBorder(int _first, int _second);
+		void UpdateEntrances(int _clusterIndex);
+		void UpdateClusterCosts(int _clusterIndex);
+
+		void RelaxNode(SearchContext &_context, OpenList *_openList, int _parentIndex, int _nodeIndex, float _gCost, int _endIndex);
+		float SearchCluster(SearchContext &_context, int _clusterIndex, int _fromIndex, int _toIndex, bool _isPlayer, bool _reverse, int &_numOps);
+
+		bool m_builtWithDiags;
+
+		int m_numXTiles, m_numYTiles;
+		int m_numXClusters, m_numYClusters;
+
+		std::vector<Cluster> m_clusters;
+		std::vector<int> m_entranceSlots;
+
+		SearchContext m_buildContext;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,333 @@
+#include "ConnectedComponents.h"
+#include "Map.h"
+#include <algorithm>
+
+// Constructor - initialises member variables and labels every tile
+ConnectedComponents::ConnectedComponents(Map *_map)
+{
+	m_map = _map;
+
+	RebuildLabels();
+}
+
+// Destructor
+ConnectedComponents::~ConnectedComponents() {}
+
+// Getters
+
+// Returns whether the labels were built with diagonal moves linking tiles
+bool ConnectedComponents::BuiltWithDiags() { return m_builtWithDiags; }
+
+// Returns whether a path exists between the two tiles, which needs both to be traversable and to have the same label
+bool ConnectedComponents::AreConnected(int _firstIndex, int _secondIndex)
+{
+	return m_labels[_firstIndex] != c_noComponent && m_labels[_firstIndex] == m_labels[_secondIndex];
+}
+
+int ConnectedComponents::GetComponent(int _nodeIndex) { return m_labels[_nodeIndex]; }
+
+// Returns how many tiles are in the component of the given tile, or zero if it isn't traversable
+int ConnectedComponents::GetComponentSize(int _nodeIndex)
+{
+	if(m_labels[_nodeIndex] == c_noComponent)
+		return 0;
+
+	return m_sizes[m_labels[_nodeIndex]];
+}
+
+int ConnectedComponents::GetNumComponents() { return m_sizes.size() - m_freeLabels.size(); }
+
+// Setters
+
+// Throws away every label and labels the map again, one flood fill for each component
+void ConnectedComponents::RebuildLabels()
+{
+	int numNodes = m_map->GetNumNodes();
+
+	m_builtWithDiags = m_map->DiagsAllowed();
+
+	m_labels.assign(numNodes, c_noComponent);
+	m_sizes.clear();
+	m_freeLabels.clear();
+
+	m_visitGenerations.assign(numNodes, 0);
+	m_visitSides.assign(numNodes, 0);
+	m_generation = 0;
+
+	for(int i = 0; i < numNodes; i++)
+	{
+		if(m_labels[i] == c_noComponent && m_map->GetNode(i).IsTraversable())
+			FillComponent(i, NewLabel());
+	}
+}
+
+// Updates the labels after the given tile changed. Only a tile turning into or out of a hole changes anything.
+// The neighbour masks must already be up to date
+void ConnectedComponents::UpdateTile(int _nodeIndex, bool _wasTraversable)
+{
+	bool traversable = m_map->GetNode(_nodeIndex).IsTraversable();
+
+	if(traversable == _wasTraversable)
+		return;
+
+	if(traversable)
+		JoinAround(_nodeIndex);
+	else
+		SplitAround(_nodeIndex, m_labels[_nodeIndex]);
+}
+
+// Returns an unused label, reusing one from a component that no longer exists if there is one
+int ConnectedComponents::NewLabel()
+{
+	if(!m_freeLabels.empty())
+	{
+		int label = m_freeLabels.back();
+		m_freeLabels.pop_back();
+
+		return label;
+	}
+
+	m_sizes.push_back(0);
+
+	return m_sizes.size() - 1;
+}
+
+// Marks a label as no longer used by any tile
+void ConnectedComponents::ReleaseLabel(int _label)
+{
+	m_sizes[_label] = 0;
+	m_freeLabels.push_back(_label);
+}
+
+// Gives the label to the tile and every tile linked to it that doesn't already have it. Components the fill
+// takes every tile from have their labels released
+void ConnectedComponents::FillComponent(int _nodeIndex, int _label)
+{
+	m_queue.clear();
+	m_queue.push_back(_nodeIndex);
+
+	m_labels[_nodeIndex] = _label;
+	m_sizes[_label]++;
+
+	for(unsigned int head = 0; head < m_queue.size(); head++)
+	{
+		int currIndex = m_queue[head];
+		unsigned char neighbourMask = m_map->GetNeighbourMask(currIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = m_map->GetNeighbourIndex(currIndex, dir);
+			int oldLabel = m_labels[neighbourIndex];
+
+			if(oldLabel == _label)
+				continue;
+
+			if(oldLabel != c_noComponent && --m_sizes[oldLabel] == 0)
+				ReleaseLabel(oldLabel);
+
+			m_labels[neighbourIndex] = _label;
+			m_sizes[_label]++;
+			m_queue.push_back(neighbourIndex);
+		}
+	}
+}
+
+// Labels a tile that has stopped being a hole. It joins the largest component around it and the tiles of any
+// other components around it are relabelled to match
+void ConnectedComponents::JoinAround(int _nodeIndex)
+{
+	unsigned char neighbourMask = m_map->GetNeighbourMask(_nodeIndex);
+	int largestLabel = c_noComponent;
+
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+	{
+		if(!(neighbourMask & (1 << dir)))
+			continue;
+
+		int label = m_labels[m_map->GetNeighbourIndex(_nodeIndex, dir)];
+
+		if(largestLabel == c_noComponent || m_sizes[label] > m_sizes[largestLabel])
+			largestLabel = label;
+	}
+
+	FillComponent(_nodeIndex, largestLabel == c_noComponent ? NewLabel() : largestLabel);
+}
+
+// Removes the label from a tile that has become a hole and splits its component if the hole cut it in two.
+// The tiles around the hole are first grouped by which of them are linked to each other directly, as tiles in
+// the same group stay connected through each other. If there is more than one group a search is run outwards
+// from each group, one tile at a time from each in turn. Searches that meet are combined, and a search that
+// runs out of tiles while another is still going has been cut off and its tiles get a new label. The last
+// search still going keeps the old label, so the work done is bounded by the size of the pieces cut off
+void ConnectedComponents::SplitAround(int _nodeIndex, int _oldLabel)
+{
+	m_labels[_nodeIndex] = c_noComponent;
+
+	if(--m_sizes[_oldLabel] == 0)
+	{
+		ReleaseLabel(_oldLabel);
+		return;
+	}
+
+	unsigned char neighbourMask = m_map->GetNeighbourMask(_nodeIndex);
+	int neighbours[NUM_DIRECTIONS];
+	int groups[NUM_DIRECTIONS];
+	int numNeighbours = 0;
+
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+	{
+		if(neighbourMask & (1 << dir))
+		{
+			neighbours[numNeighbours] = m_map->GetNeighbourIndex(_nodeIndex, dir);
+			groups[numNeighbours] = numNeighbours;
+			numNeighbours++;
+		}
+	}
+
+	// Joins the groups of any two neighbours that are linked to each other, until nothing changes
+	bool changed = true;
+
+	while(changed)
+	{
+		changed = false;
+
+		for(int a = 0; a < numNeighbours; a++)
+		{
+			unsigned char mask = m_map->GetNeighbourMask(neighbours[a]);
+
+			for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+			{
+				if(!(mask & (1 << dir)))
+					continue;
+
+				int linkedIndex = m_map->GetNeighbourIndex(neighbours[a], dir);
+
+				for(int b = 0; b < numNeighbours; b++)
+				{
+					if(neighbours[b] == linkedIndex && groups[b] != groups[a])
+					{
+						int group = std::min(groups[a], groups[b]);
+						groups[a] = group;
+						groups[b] = group;
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+
+	// Each search keeps every tile it has reached, with the ones before the head already expanded
+	struct SideSearch
+	{
+		std::vector<int> nodes;
+		unsigned int head;
+		bool active;
+	};
+
+	SideSearch searches[NUM_DIRECTIONS];
+	int sideOwners[NUM_DIRECTIONS];
+	int numActive = 0;
+
+	if(++m_generation == 0)
+	{
+		std::fill(m_visitGenerations.begin(), m_visitGenerations.end(), 0);
+		m_generation = 1;
+	}
+
+	for(int i = 0; i < numNeighbours; i++)
+	{
+		searches[i].head = 0;
+		searches[i].active = (groups[i] == i);
+		sideOwners[i] = groups[i];
+
+		if(searches[i].active)
+			numActive++;
+	}
+
+	if(numActive <= 1)
+		return;
+
+	for(int i = 0; i < numNeighbours; i++)
+	{
+		searches[groups[i]].nodes.push_back(neighbours[i]);
+		m_visitGenerations[neighbours[i]] = m_generation;
+		m_visitSides[neighbours[i]] = groups[i];
+	}
+
+	while(numActive > 1)
+	{
+		for(int s = 0; s < numNeighbours && numActive > 1; s++)
+		{
+			SideSearch &search = searches[s];
+
+			if(!search.active)
+				continue;
+
+			// A search with nothing left to expand has been cut off from the rest of the component
+			if(search.head == search.nodes.size())
+			{
+				int label = NewLabel();
+
+				for(int nodeIndex : search.nodes)
+					m_labels[nodeIndex] = label;
+
+				m_sizes[label] = search.nodes.size();
+				m_sizes[_oldLabel] -= search.nodes.size();
+
+				search.active = false;
+				numActive--;
+				continue;
+			}
+
+			int currIndex = search.nodes[search.head++];
+			unsigned char mask = m_map->GetNeighbourMask(currIndex);
+
+			for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+			{
+				if(!(mask & (1 << dir)))
+					continue;
+
+				int neighbourIndex = m_map->GetNeighbourIndex(currIndex, dir);
+
+				if(m_visitGenerations[neighbourIndex] != m_generation)
+				{
+					m_visitGenerations[neighbourIndex] = m_generation;
+					m_visitSides[neighbourIndex] = s;
+					search.nodes.push_back(neighbourIndex);
+					continue;
+				}
+
+				// Reached a tile another search has already reached, so that search is combined into this
+				// one. Its tiles are marked with the side they came from, which now belongs to this search
+				int other = sideOwners[m_visitSides[neighbourIndex]];
+
+				if(other == s)
+					continue;
+
+				SideSearch &otherSearch = searches[other];
+				std::vector<int> combined;
+
+				combined.insert(combined.end(), search.nodes.begin(), search.nodes.begin() + search.head);
+				combined.insert(combined.end(), otherSearch.nodes.begin(), otherSearch.nodes.begin() + otherSearch.head);
+				combined.insert(combined.end(), search.nodes.begin() + search.head, search.nodes.end());
+				combined.insert(combined.end(), otherSearch.nodes.begin() + otherSearch.head, otherSearch.nodes.end());
+
+				search.head += otherSearch.head;
+				search.nodes.swap(combined);
+
+				otherSearch.nodes.clear();
+				otherSearch.active = false;
+				numActive--;
+
+				for(int i = 0; i < numNeighbours; i++)
+				{
+					if(sideOwners[i] == other)
+						sideOwners[i] = s;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef CONNECTEDCOMPONENTS_H
+#define CONNECTEDCOMPONENTS_H
+
+#include <vector>
+
+class Map;
+
+// Label given to tiles that can't be moved onto
+const int c_noComponent = -1;
+
+// Labels every traversable tile with the connected component it belongs to, using the same links between
+// tiles as the searches, so two tiles are connected exactly when a path exists between them. Labels are kept
+// up to date as tiles are turned into or out of holes. Filling a hole joins the components around it by
+// relabelling all but the largest. Making a hole searches outwards from each side of it in lockstep, which
+// stops as soon as all but one side have either met or run out of tiles, so only the pieces cut off are
+// relabelled. Enemies only change costs, never which tiles are connected
+class ConnectedComponents
+{
+	public:
+		// Constructor and destructor
+		ConnectedComponents(Map *_map);
+		~ConnectedComponents();
+
+		// Getters
+		bool BuiltWithDiags();
+		bool AreConnected(int _firstIndex, int _secondIndex);
+		int GetComponent(int _nodeIndex);
+		int GetComponentSize(int _nodeIndex);
+		int GetNumComponents();
+
+		// Setters
+		void RebuildLabels();
+		void UpdateTile(int _nodeIndex, bool _wasTraversable);
+
+	private:
+		int NewLabel();
+		void ReleaseLabel(int _label);
+		void FillComponent(int _nodeIndex, int _label);
+		void JoinAround(int _nodeIndex);
+		void SplitAround(int _nodeIndex, int _oldLabel);
+
+		bool m_builtWithDiags;
+
+		std::vector<int> m_labels;
+		std::vector<int> m_sizes;
+		std::vector<int> m_freeLabels;
+
+		// Which side of a new hole each tile has been reached from, valid only for the current generation
+		std::vector<unsigned int> m_visitGenerations;
+		std::vector<int> m_visitSides;
+		unsigned int m_generation;
+
+		std::vector<int> m_queue;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "DStarLite.h"
+#include "Map.h"
+#include <limits>
+
+static const float c_infinity = std::numeric_limits<float>::infinity();
+
+// Constructor - initialises member variables
+DStarLite::DStarLite(Map *_map, bool _isPlayer)
+{
+	m_map = _map;
+	m_isPlayer = _isPlayer;
+	m_startIndex = -1;
+	m_endIndex = -1;
+	m_lastIndex = -1;
+	m_keyModifier = 0.0f;
+	m_mapVersion = 0;
+}
+
+// Destructor
+DStarLite::~DStarLite() {}
+
+// Finds a path from the start to the end. If the end is the same as the last query only the nodes around the
+// changes made to the map since then are updated, otherwise the search starts again. Returns whether a path
+// was found, in which case the parents on the context lead from the end node back to the start
+bool DStarLite::FindPath(SearchContext &_context, int _startIndex, int _endIndex, int &_numOps)
+{
+	int numNodes = m_map->GetNumNodes();
+
+	m_changedNodes.clear();
+
+	bool canRepair = (_endIndex == m_endIndex && (int)m_gCosts.size() == numNodes);
+
+	if(!canRepair || !m_map->GetChangesSince(m_mapVersion, m_changedNodes))
+		Initialise(_startIndex, _endIndex);
+
+	else
+	{
+		m_startIndex = _startIndex;
+		ApplyChanges(m_changedNodes, _startIndex);
+	}
+
+	m_mapVersion = m_map->GetMapVersion();
+
+	ComputeShortestPath(_numOps);
+
+	if(m_gCosts[_startIndex] == c_infinity)
+		return false;
+
+	// Walks from the start to the end by always moving to the neighbour with the cheapest cost to the end and
+	// stores each step as a parent on the context. A node being reached twice means the costs are not settled
+	_context.SetSearchState(_startIndex, NODE_CLOSED);
+	_context.SetParent(_startIndex, -1);
+
+	int currIndex = _startIndex;
+
+	while(currIndex != _endIndex)
+	{
+		unsigned char neighbourMask = m_map->GetNeighbourMask(currIndex);
+		int bestIndex = -1;
+		float bestCost = c_infinity;
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = m_map->GetNeighbourIndex(currIndex, dir);
+			float cost = m_map->GetMoveCost(currIndex, neighbourIndex, m_isPlayer) + m_gCosts[neighbourIndex];
+
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestIndex = neighbourIndex;
+			}
+		}
+
+		if(bestIndex == -1 || _context.GetSearchState(bestIndex) == NODE_CLOSED)
+			return false;
+
+		_context.SetSearchState(bestIndex, NODE_CLOSED);
+		_context.SetParent(bestIndex, currIndex);
+
+		currIndex = bestIndex;
+	}
+
+	return true;
+}
+
+// Returns the priority of a node on the open list
+DStarKey DStarLite::CalcKey(int _nodeIndex)
+{
+	float minCost = min(m_gCosts[_nodeIndex], m_rhsCosts[_nodeIndex]);
+	DStarKey key = { minCost + Heuristic(m_startIndex, _nodeIndex) + m_keyModifier, minCost };
+
+	return key;
+}
+
+// Returns an estimate of the cost between two nodes that is never more than the real cost
+float DStarLite::Heuristic(int _first, int _second)
+{
+	return m_map->DistBetweenNodes(m_map->GetNode(_first), m_map->GetNode(_second)) * c_minCostPerDistance;
+}
+
+// Clears all of the search state and starts a new search backwards from the end
+void DStarLite::Initialise(int _startIndex, int _endIndex)
+{
+	int numNodes = m_map->GetNumNodes();
+
+	m_startIndex = _startIndex;
+	m_endIndex = _endIndex;
+	m_lastIndex = _startIndex;
+	m_keyModifier = 0.0f;
+
+	m_gCosts.assign(numNodes, c_infinity);
+	m_rhsCosts.assign(numNodes, c_infinity);
+	m_keys.assign(numNodes, DStarKey());
+	m_open.assign(numNodes, false);
+	m_openList = std::priority_queue<DStarEntry, std::vector<DStarEntry>, std::greater<DStarEntry>>();
+
+	m_rhsCosts[_endIndex] = 0.0f;
+	UpdateNode(_endIndex);
+}
+
+// Updates every node whose costs may have changed. A change to a node changes the cost of every move into
+// and out of it, so its neighbours are updated as well. The key modifier is raised by how far the start has
+// moved so the keys already on the open list stay valid
+void DStarLite::ApplyChanges(std::vector<int> &_changedNodes, int _startIndex)
+{
+	m_keyModifier += Heuristic(m_lastIndex, _startIndex);
+	m_lastIndex = _startIndex;
+
+	int numXTiles = m_map->GetNumXTiles();
+	int numYTiles = m_map->GetNumYTiles();
+
+	for(int nodeIndex : _changedNodes)
+	{
+		int tileX = nodeIndex % numXTiles;
+		int tileY = nodeIndex / numXTiles;
+
+		UpdateNode(nodeIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			int x = tileX + c_dirX[dir];
+			int y = tileY + c_dirY[dir];
+
+			if(x >= 0 && x < numXTiles && y >= 0 && y < numYTiles)
+				UpdateNode(y * numXTiles + x);
+		}
+	}
+
+	// Drops the entries that are no longer valid once they make up most of the open list
+	if((int)m_openList.size() > 4 * m_map->GetNumNodes())
+	{
+		m_openList = std::priority_queue<DStarEntry, std::vector<DStarEntry>, std::greater<DStarEntry>>();
+
+		for(unsigned int n = 0; n < m_open.size(); n++)
+		{
+			if(m_open[n])
+			{
+				DStarEntry entry = { m_keys[n], (int)n };
+				m_openList.push(entry);
+			}
+		}
+	}
+}
+
+// Recalculates the cheapest cost from a node to the end through its neighbours and puts it on the open list if
+// that no longer matches the cost the node was last settled at
+void DStarLite::UpdateNode(int _nodeIndex)
+{
+	if(_nodeIndex != m_endIndex)
+	{
+		float rhsCost = c_infinity;
+
+		if(m_map->GetNode(_nodeIndex).IsTraversable())
+		{
+			unsigned char neighbourMask = m_map->GetNeighbourMask(_nodeIndex);
+
+			for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+			{
+				if(!(neighbourMask & (1 << dir)))
+					continue;
+
+				int neighbourIndex = m_map->GetNeighbourIndex(_nodeIndex, dir);
+
+				rhsCost = min(rhsCost, m_map->GetMoveCost(_nodeIndex, neighbourIndex, m_isPlayer) + m_gCosts[neighbourIndex]);
+			}
+		}
+
+		m_rhsCosts[_nodeIndex] = rhsCost;
+	}
+
+	m_open[_nodeIndex] = false;
+
+	if(m_gCosts[_nodeIndex] != m_rhsCosts[_nodeIndex])
+	{
+		DStarEntry entry = { CalcKey(_nodeIndex), _nodeIndex };
+
+		m_keys[_nodeIndex] = entry.key;
+		m_open[_nodeIndex] = true;
+		m_openList.push(entry);
+	}
+}
+
+// Settles nodes in order of their keys until the cost from the start to the end is known
+void DStarLite::ComputeShortestPath(int &_numOps)
+{
+	while(true)
+	{
+		// Skips entries for nodes that have since been settled or given a new key
+		while(!m_openList.empty() && (!m_open[m_openList.top().nodeIndex] || !(m_openList.top().key == m_keys[m_openList.top().nodeIndex])))
+			m_openList.pop();
+
+		if(m_openList.empty())
+			break;
+
+		DStarEntry top = m_openList.top();
+
+		if(!(top.key < CalcKey(m_startIndex)) && m_rhsCosts[m_startIndex] == m_gCosts[m_startIndex])
+			break;
+
+		m_openList.pop();
+
+		_numOps++;
+
+		int currIndex = top.nodeIndex;
+		DStarKey newKey = CalcKey(currIndex);
+
+		// The start has moved since the node was added so it is put back with its current key
+		if(top.key < newKey)
+		{
+			DStarEntry entry = { newKey, currIndex };
+
+			m_keys[currIndex] = newKey;
+			m_openList.push(entry);
+			continue;
+		}
+
+		m_open[currIndex] = false;
+
+		// The cost to the end has dropped, so it is settled and the neighbours that move through it are updated.
+		// Otherwise it has risen, so it is reset and updated along with those neighbours
+		if(m_gCosts[currIndex] > m_rhsCosts[currIndex])
+			m_gCosts[currIndex] = m_rhsCosts[currIndex];
+
+		else
+		{
+			m_gCosts[currIndex] = c_infinity;
+			UpdateNode(currIndex);
+		}
+
+		unsigned char neighbourMask = m_map->GetNeighbourMask(currIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(neighbourMask & (1 << dir))
+				UpdateNode(m_map->GetNeighbourIndex(currIndex, dir));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include "SearchContext.h"
+
+class Map;
+
+// Priority of a node on the D* Lite open list. Keys are compared on the first value and then the second
+struct DStarKey
+{
+	float first;
+	float second;
+
+	bool operator<(const DStarKey &_other) const { return first < _other.first || (first == _other.first && second < _other.second); }
+	bool operator==(const DStarKey &_other) const { return first == _other.first && second == _other.second; }
+};
+
+// Entry on the D* Lite open list. Entries are not removed when a node's key changes, so an entry whose key
+// no longer matches the key stored for its node is skipped when it reaches the top
+struct DStarEntry
+{
+	DStarKey key;
+	int nodeIndex;
+
+	bool operator>(const DStarEntry &_other) const { return _other.key < key; }
+};
+
+// Incremental planner that keeps its search state between queries so a path can be repaired after the map
+// changes instead of being found again from scratch. It searches backwards from the destination, so the
+// costs it has found stay valid as the entity moves towards it, and only the nodes around the changes in
+// the map's change log are updated. Each entity that repairs its path needs its own planner
+class DStarLite
+{
+	public:
+		// Constructor and destructor
+		DStarLite(Map *_map, bool _isPlayer);
+		~DStarLite();
+
+		bool FindPath(SearchContext &_context, int _startIndex, int _endIndex, int &_numOps);
+
+	private:
+		DStarKey CalcKey(int _nodeIndex);
+		float Heuristic(int _first, int _second);
+
+		void Initialise(int _startIndex, int _endIndex);
+		void ApplyChanges(std::vector<int> &_changedNodes, int _startIndex);
+		void UpdateNode(int _nodeIndex);
+		void ComputeShortestPath(int &_numOps);
+
+		bool m_isPlayer;
+
+		int m_startIndex;
+		int m_endIndex;
+		int m_lastIndex;
+
+		float m_keyModifier;
+		unsigned int m_mapVersion;
+
+		std::vector<float> m_gCosts;
+		std::vector<float> m_rhsCosts;
+		std::vector<DStarKey> m_keys;
+		std::vector<bool> m_open;
+		std::vector<int> m_changedNodes;
+
+		std::priority_queue<DStarEntry, std::vector<DStarEntry>, std::greater<DStarEntry>> m_openList;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef DIRECTIONS_H
+#define DIRECTIONS_H
+
+// The eight directions a node can be linked to its neighbours in. Each node stores a neighbour mask with
+// the bit for a direction set when the neighbour in that direction can be moved to. The directions are
+// ordered so that the opposite of a direction is always 7 minus that direction
+enum Direction
+{
+	DIR_NORTH_WEST = 0,
+	DIR_NORTH = 1,
+	DIR_NORTH_EAST = 2,
+	DIR_WEST = 3,
+	DIR_EAST = 4,
+	DIR_SOUTH_WEST = 5,
+	DIR_SOUTH = 6,
+	DIR_SOUTH_EAST = 7,
+	NUM_DIRECTIONS = 8
+};
+
+// Tile offsets for each direction
+const int c_dirX[NUM_DIRECTIONS] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+const int c_dirY[NUM_DIRECTIONS] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+
+// Masks covering the straight and diagonal directions
+const unsigned char c_orthogonalMask = (1 << DIR_NORTH) | (1 << DIR_WEST) | (1 << DIR_EAST) | (1 << DIR_SOUTH);
+const unsigned char c_diagonalMask = (1 << DIR_NORTH_WEST) | (1 << DIR_NORTH_EAST) | (1 << DIR_SOUTH_WEST) | (1 << DIR_SOUTH_EAST);
+
+inline int OppositeDirection(int _dir) { return NUM_DIRECTIONS - 1 - _dir; }
+inline bool IsDiagonal(int _dir) { return ((c_diagonalMask >> _dir) & 1) != 0; }
+
+#endif
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "DistanceField.h"
+#include "Map.h"
+#include "OccupancyMap.h"
+#include <limits>
+
+static const float c_infinity = std::numeric_limits<float>::infinity();
+
+// Direction stored for tiles that have no route to the target, and for the target itself
+static const unsigned char c_noDirection = NUM_DIRECTIONS;
+
+// Distances kept when the target moves are found by subtraction, so a route has to be cheaper by more than
+// this to replace the one a tile already has
+static const float c_fieldTolerance = 0.001f;
+
+// Constructor - initialises member variables. The field is built the first time it is updated
+DistanceField::DistanceField(Map *_map, bool _isPlayer, bool _reversed)
+{
+	m_map = _map;
+	m_isPlayer = _isPlayer;
+	m_reversed = _reversed;
+	m_built = false;
+	m_targetIndex = -1;
+	m_numOps = 0;
+	m_mapVersion = 0;
+	m_markGeneration = 0;
+}
+
+// Destructor
+DistanceField::~DistanceField() {}
+
+// Getters
+
+int DistanceField::GetTargetIndex() { return m_targetIndex; }
+
+// Returns the number of tiles searched by the last update
+int DistanceField::GetNumOps() { return m_numOps; }
+
+// Returns the cost of the cheapest route from the given tile to the target, or infinity if there isn't one
+float DistanceField::GetDistance(int _nodeIndex) { return m_distances[_nodeIndex]; }
+
+// Returns the direction of the first move from the given tile towards the target, or NUM_DIRECTIONS if the
+// tile is the target or has no route to it
+int DistanceField::GetDirection(int _nodeIndex) { return m_directions[_nodeIndex]; }
+
+// Returns the centre of the next tile on the route from the given position to the target, or (-1,-1) if the
+// position is on the target tile or has no route to it
+glm::vec2 DistanceField::GetNextPoint(glm::vec2 _pos)
+{
+	int nodeIndex = m_map->GetNodeIndex(_pos);
+
+	if(m_directions[nodeIndex] == c_noDirection)
+		return glm::vec2(-1,-1);
+
+	return m_map->GetNode(m_map->GetNeighbourIndex(nodeIndex, m_directions[nodeIndex])).GetPos();
+}
+
+// Setters
+
+// Brings the field up to date with the map and moves it to the tile at the given position. Only the tiles
+// affected by the map's changes since the last update and by the target moving are searched again. If the
+// changes are no longer in the map's change log the whole field is built again
+void DistanceField::Update(glm::vec2 _targetPos)
+{
+	int targetIndex = m_map->GetNodeIndex(_targetPos);
+	std::vector<int> changedNodes;
+
+	m_numOps = 0;
+
+	if(!m_built || (int)m_distances.size() != m_map->GetNumNodes() || !m_map->GetChangesSince(m_mapVersion, changedNodes))
+		Rebuild(targetIndex);
+
+	else
+	{
+		if(!changedNodes.empty())
+			ApplyChanges(changedNodes);
+
+		if(targetIndex != m_targetIndex)
+			MoveTarget(targetIndex);
+	}
+
+	m_mapVersion = m_map->GetMapVersion();
+}
+
+// Returns a value that changes whenever the cost of moving onto or off the given tile changes for the type
+// of entity the field is for, or -1 if the tile can't be walked on
+float DistanceField::GetCostSignature(int _nodeIndex)
+{
+	Node &node = m_map->GetNode(_nodeIndex);
+
+	if(!node.IsTraversable())
+		return -1.0f;
+
+	if(m_isPlayer)
+		return node.GetTileCost() * m_map->GetOccupancy()->GetCostScale(_nodeIndex);
+
+	return node.GetTileCost();
+}
+
+// Returns the cost of the step from a tile to the next tile on its route. Routes in a reversed field lead out
+// of the target, so the step is walked from the next tile to this one
+float DistanceField::GetStepCost(int _nodeIndex, int _nextIndex)
+{
+	if(m_reversed)
+		return m_map->GetMoveCost(_nextIndex, _nodeIndex, m_isPlayer);
+
+	return m_map->GetMoveCost(_nodeIndex, _nextIndex, m_isPlayer);
+}
+
+// Clears the field and searches the whole map outwards from the target
+void DistanceField::Rebuild(int _targetIndex)
+{
+	int numNodes = m_map->GetNumNodes();
+
+	m_targetIndex = _targetIndex;
+	m_built = true;
+
+	m_distances.assign(numNodes, c_infinity);
+	m_directions.assign(numNodes, c_noDirection);
+	m_costSignatures.resize(numNodes);
+	m_marks.assign(numNodes, 0);
+	m_markGeneration = 0;
+
+	for(int n = 0; n < numNodes; n++)
+		m_costSignatures[n] = GetCostSignature(n);
+
+	m_openList = std::priority_queue<FieldEntry, std::vector<FieldEntry>, std::greater<FieldEntry>>();
+
+	if(m_map->GetNode(_targetIndex).IsTraversable())
+	{
+		m_distances[_targetIndex] = 0.0f;
+		m_openList.push({ 0.0f, _targetIndex });
+	}
+
+	Propagate();
+}
+
+// Searches again from the tiles whose costs have changed. A tile whose cost went up may have made the routes
+// through it more expensive, so every tile with a route through it is cleared and given the cheapest route
+// from its neighbours that are still valid. A tile whose cost went down is searched from again, which passes
+// the cheaper routes on to any tile that can use them
+void DistanceField::ApplyChanges(std::vector<int> &_changedNodes)
+{
+	std::vector<int> region;
+
+	m_markGeneration++;
+
+	for(int nodeIndex : _changedNodes)
+	{
+		float signature = GetCostSignature(nodeIndex);
+
+		if(signature == m_costSignatures[nodeIndex])
+			continue;
+
+		m_costSignatures[nodeIndex] = signature;
+
+		MarkSubtree(nodeIndex, region);
+	}
+
+	if(region.empty())
+		return;
+
+	for(int nodeIndex : region)
+	{
+		m_distances[nodeIndex] = c_infinity;
+		m_directions[nodeIndex] = c_noDirection;
+	}
+
+	ReseedNodes(region);
+	Propagate();
+}
+
+// Moves the target to a neighbouring tile. Tiles whose route passed through the new target keep it, with the
+// cost of the rest of the old route taken off, which is exact. Every other tile keeps its route to the old
+// target plus the move on to the new one, which is a real route but may no longer be the cheapest. Searching
+// outwards from the kept tiles next to the others then passes on every cheaper route, and only the tiles that
+// find one are searched. A target that jumps further than one tile is built again from scratch
+void DistanceField::MoveTarget(int _targetIndex)
+{
+	int oldTargetIndex = m_targetIndex;
+	int moveDir = -1;
+	unsigned char neighbourMask = m_map->GetNeighbourMask(oldTargetIndex);
+
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+	{
+		if((neighbourMask & (1 << dir)) && m_map->GetNeighbourIndex(oldTargetIndex, dir) == _targetIndex)
+			moveDir = dir;
+	}
+
+	if(moveDir == -1 || m_distances[oldTargetIndex] != 0.0f || m_distances[_targetIndex] == c_infinity)
+	{
+		Rebuild(_targetIndex);
+		return;
+	}
+
+	std::vector<int> kept;
+	float offset = m_distances[_targetIndex];
+	float moveCost = GetStepCost(oldTargetIndex, _targetIndex);
+
+	m_markGeneration++;
+	MarkSubtree(_targetIndex, kept);
+
+	for(int n = 0; n < m_map->GetNumNodes(); n++)
+	{
+		if(m_distances[n] == c_infinity)
+			continue;
+
+		if(m_marks[n] == m_markGeneration)
+			m_distances[n] -= offset;
+		else
+			m_distances[n] += moveCost;
+	}
+
+	m_targetIndex = _targetIndex;
+	m_distances[_targetIndex] = 0.0f;
+	m_directions[_targetIndex] = c_noDirection;
+	m_directions[oldTargetIndex] = moveDir;
+
+	for(int nodeIndex : kept)
+	{
+		unsigned char keptMask = m_map->GetNeighbourMask(nodeIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if((keptMask & (1 << dir)) && m_marks[m_map->GetNeighbourIndex(nodeIndex, dir)] != m_markGeneration)
+			{
+				m_openList.push({ m_distances[nodeIndex], nodeIndex });
+				break;
+			}
+		}
+	}
+
+	Propagate();
+}
+
+// Marks the given tile and every tile whose route to the target passes through it, and adds each one that
+// wasn't already marked to the list
+void DistanceField::MarkSubtree(int _rootIndex, std::vector<int> &_subtree)
+{
+	std::vector<int> stack(1, _rootIndex);
+	int numXTiles = m_map->GetNumXTiles();
+	int numYTiles = m_map->GetNumYTiles();
+
+	while(!stack.empty())
+	{
+		int nodeIndex = stack.back();
+		stack.pop_back();
+
+		if(m_marks[nodeIndex] == m_markGeneration)
+			continue;
+
+		m_marks[nodeIndex] = m_markGeneration;
+		_subtree.push_back(nodeIndex);
+
+		// Neighbour masks may have changed since the routes were found, so every tile around this one is
+		// checked for a route leading into it
+		int tileX = nodeIndex % numXTiles;
+		int tileY = nodeIndex / numXTiles;
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			int x = tileX + c_dirX[dir];
+			int y = tileY + c_dirY[dir];
+
+			if(x < 0 || x >= numXTiles || y < 0 || y >= numYTiles)
+				continue;
+
+			int neighbourIndex = y * numXTiles + x;
+
+			if(m_directions[neighbourIndex] == OppositeDirection(dir))
+				stack.push_back(neighbourIndex);
+		}
+	}
+}
+
+// Gives each of the given tiles the cheapest route through a neighbour that isn't part of the region being
+// searched again, and adds the ones that have a route to the open list. The target always has a cost of zero
+void DistanceField::ReseedNodes(std::vector<int> &_nodes)
+{
+	for(int nodeIndex : _nodes)
+	{
+		if(m_costSignatures[nodeIndex] < 0.0f)
+			continue;
+
+		if(nodeIndex == m_targetIndex)
+		{
+			m_distances[nodeIndex] = 0.0f;
+			m_openList.push({ 0.0f, nodeIndex });
+			continue;
+		}
+
+		unsigned char neighbourMask = m_map->GetNeighbourMask(nodeIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = m_map->GetNeighbourIndex(nodeIndex, dir);
+
+			if(m_marks[neighbourIndex] == m_markGeneration || m_distances[neighbourIndex] == c_infinity)
+				continue;
+
+			float cost = GetStepCost(nodeIndex, neighbourIndex) + m_distances[neighbourIndex];
+
+			if(cost < m_distances[nodeIndex])
+			{
+				m_distances[nodeIndex] = cost;
+				m_directions[nodeIndex] = dir;
+			}
+		}
+
+		if(m_distances[nodeIndex] != c_infinity)
+			m_openList.push({ m_distances[nodeIndex], nodeIndex });
+	}
+}
+
+// Runs Dijkstra's algorithm outwards from the tiles on the open list. Each tile taken off the list offers its
+// route to its neighbours, costing the step in the direction the route walks it
+void DistanceField::Propagate()
+{
+	while(!m_openList.empty())
+	{
+		FieldEntry entry = m_openList.top();
+		m_openList.pop();
+
+		if(entry.cost > m_distances[entry.nodeIndex])
+			continue;
+
+		m_numOps++;
+
+		unsigned char neighbourMask = m_map->GetNeighbourMask(entry.nodeIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = m_map->GetNeighbourIndex(entry.nodeIndex, dir);
+			float cost = entry.cost + GetStepCost(neighbourIndex, entry.nodeIndex);
+
+			if(cost + c_fieldTolerance < m_distances[neighbourIndex])
+			{
+				m_distances[neighbourIndex] = cost;
+				m_directions[neighbourIndex] = OppositeDirection(dir);
+				m_openList.push({ cost, neighbourIndex });
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include "glm\glm.hpp"
+
+class Map;
+
+// Entry on the distance field's open list. Entries are left on the list when a node's distance drops, so an
+// entry costing more than the distance stored for its node is skipped when it reaches the top
+struct FieldEntry
+{
+	float cost;
+	int nodeIndex;
+
+	bool operator>(const FieldEntry &_other) const { return cost > _other.cost; }
+};
+
+// Cost of the cheapest route from every tile to one target tile, found with a single Dijkstra search outwards
+// from the target that costs each move in the direction it would be walked. Each tile also stores the
+// direction of the first move on its route, so any number of entities heading for the target can each find
+// their next tile with one lookup instead of searching for their own path.
+//
+// A reversed field holds the cost of the cheapest route from the target to every tile instead, with each tile
+// storing the direction of the last move on its route back towards the target.
+//
+// The routes form a tree rooted at the target. When tiles change only the parts of the tree hanging from
+// them are searched again, and when the target moves to a neighbouring tile only the tiles that find a
+// cheaper route to the new target than going through the old one are searched again
+class DistanceField
+{
+	public:
+		// Constructor and destructor
+		DistanceField(Map *_map, bool _isPlayer, bool _reversed = false);
+		~DistanceField();
+
+		// Getters
+		int GetTargetIndex();
+		int GetNumOps();
+		float GetDistance(int _nodeIndex);
+		int GetDirection(int _nodeIndex);
+		glm::vec2 GetNextPoint(glm::vec2 _pos);
+
+		// Setters
+		void Update(glm::vec2 _targetPos);
+
+	private:
+		float GetCostSignature(int _nodeIndex);
+		float GetStepCost(int _nodeIndex, int _nextIndex);
+
+		void Rebuild(int _targetIndex);
+		void ApplyChanges(std::vector<int> &_changedNodes);
+		void MoveTarget(int _targetIndex);
+		void MarkSubtree(int _rootIndex, std::vector<int> &_subtree);
+		void ReseedNodes(std::vector<int> &_nodes);
+		void Propagate();
+
+		bool m_isPlayer;
+		bool m_reversed;
+		bool m_built;
+
+		int m_targetIndex;
+		int m_numOps;
+
+		unsigned int m_mapVersion;
+		unsigned int m_markGeneration;
+
+		std::vector<float> m_distances;
+		std::vector<unsigned char> m_directions;
+		std::vector<float> m_costSignatures;
+		std::vector<unsigned int> m_marks;
+
+		std::priority_queue<FieldEntry, std::vector<FieldEntry>, std::greater<FieldEntry>> m_openList;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
@@ -1,14 +1,13 @@
 #include "Enemy.h"
+#include "DistanceField.h"
 #include <cstdlib>
 #include <time.h>
+#include <limits>
 
 // Constructor - initialises member variables
 Enemy::Enemy(glm::vec2 _spawnPoint, float _range, Map *_map, Player *_player)
 {
 	m_destination = glm::vec2(-1,-1);
-	m_sprite = al_load_bitmap("Enemy.png");
-	m_spriteWidth = al_get_bitmap_width(m_sprite);
-	m_spriteHeight = al_get_bitmap_height(m_sprite);
 	m_pathRequestTimer = 20.1f;
 	m_targettingPlayer = false;
 	m_player = _player;
@@ -19,50 +18,35 @@ Enemy::Enemy(glm::vec2 _spawnPoint, float _range, Map *_map, Player *_player)
 	m_spawnPoint = _spawnPoint;
 	m_range = _range;
 	srand(time(NULL));
+
+	// The enemy is counted on the tile it spawns on so that moving off it later takes away its own count
+	m_map->AddEnemyToNode(m_pos);
 }
 
 //Destructor - deletes necessary objects to prevent memory leaks
-Enemy::~Enemy() { al_destroy_bitmap(m_sprite); }
+Enemy::~Enemy()
+{
+	m_map->RemoveEnemyFromNode(m_prevPos);
+}
 
 // Sets the destination of the enemy
 void Enemy::SetDestination(glm::vec2 _dest) { m_destination = _dest; }
 
-// Generates a random position until it finds one that is valid and reachable and then
-// requests a path to that position
+// Picks a random tile within the range of this enemy's spawn point that it can reach and requests a path to it.
+// The map only picks tiles that are connected to the enemy, so a single search is enough. If there are none
+// the enemy stays where it is until the next attempt
 void Enemy::GenerateRandomTarget()
 {
-	bool goodTarget = false;
-
-	while(!goodTarget && !m_hasPath)
-	{
-		bool inBounds = false;
-
-		glm::vec2 target, rangeTarget;
-
-		while(!goodTarget)
-		{
-			// Generate a random position vector within the bounds of the range of this enemy and its spawn point
-			target = glm::vec2(rand() % (int)((m_range*2) - m_range), rand() % (int)((m_range*2) - m_range));
-			rangeTarget = glm::vec2(m_spawnPoint.x + target.x, m_spawnPoint.y + target.y);
-
-			// If the position generated is on the map, at least a specified distance away from the spawn point
-			// and is traversable i.e. not an obstacle then the point is good and the program continues
-			if((rangeTarget.x > 0 && rangeTarget.x < 1000 && rangeTarget.y > 0 && rangeTarget.y < 1000) && glm::distance(rangeTarget, m_pos) > 100.0f)
-			{
-				if(m_range > glm::distance(m_spawnPoint, rangeTarget) && m_map->IsPointTraversable(rangeTarget))
-					goodTarget = true;
-			}
-		}
+	glm::vec2 target;
 
-		// A path is requested to the point generated above. If a path is found the program ends, otherwise the function
-		// starts again with a new point
-		m_destination = rangeTarget;
+	if(!m_map->GetRandomReachablePoint(m_pos, m_spawnPoint, m_range, c_minTargetDistance, target))
+		return;
 
-		RequestPath(0);
+	m_destination = target;
 
-		if(!m_hasPath)
-			ClearPath();		
-	}	
+	// Each wander goes somewhere new, so a D* Lite planner would have to start again every time and its saved
+	// search state would only cost memory. Plain A Star is used instead
+	RequestPath(ALGO_A_STAR);
 }
 
 // Update loop that gets called every time the game loops. Calculates movement
@@ -73,9 +57,13 @@ void Enemy::Update()
 
 	TimedUpdate();
 
+	// While chasing the player the enemy is steered by the map's distance field instead of following a path
+	if(m_targettingPlayer)
+		ChasePlayer();
+
 	// If the enemy does not have a path and the timer is above the limit request
 	// a new path to a random position and reset the time.
-	if(!m_hasPath)
+	else if(!m_hasPath)
 	{
 		if(m_pathRequestTimer > 20.0f)
 		{
@@ -91,48 +79,34 @@ void Enemy::Update()
 
 void Enemy::TimedUpdate()
 {
-	// This code is for getting the enemy to seek the player if it gets too close, however it isn't working correctly
-	
-	/*if(glm::distance(m_pos, m_spawnPoint) > 300.0f)
-	{
-		m_targettingPlayer = false;
-		m_destination = m_spawnPoint;
-		RequestPath(1);
-	}
+	// The enemy chases the player when they come close while inside the area the enemy roams and can be reached,
+	// and goes back to roaming as soon as the player leaves that area
+	bool playerInRange = glm::distance(m_player->GetPosition(), m_spawnPoint) < m_range;
 
-	else if(glm::distance(m_pos, m_player->GetPosition()) < 200.0f && m_destination != m_spawnPoint)
-	{
-		m_targettingPlayer = true;
-	}
-	
-	if(glm::distance(m_pos, m_spawnPoint) > 300.0f)
-	{
-		m_targettingPlayer = false;
-		m_destination = m_spawnPoint;
-		RequestPath(1);
-	}
-	
-	if(m_targettingPlayer)
+	if(!m_targettingPlayer && playerInRange && glm::distance(m_pos, m_player->GetPosition()) < c_chaseRange)
 	{
-		m_destination = m_player->GetPosition();
-		RequestPath(1);
-	}*/
+		DistanceField *field = m_map->GetDistanceField(m_player->GetPosition(), m_isPlayer);
 
-	if(m_hasPath)
-	{
-		// This checks the next few points in the path to see if they have changed. This is more efficient that generating
-		// a new path every second but only checks if the path has changed and doesn't take into account if other terrain has
-		// changed which might provide a better path.
-		if(m_path->CheckNextPoints())
+		if(field->GetDistance(m_map->GetNodeIndex(m_pos)) != numeric_limits<float>::infinity())
 		{
-			int tempAlgo = m_path->GetAlgoType();
+			m_targettingPlayer = true;
 			ClearPath();
-			RequestPath(tempAlgo);
 		}
 	}
 
-	// If the node the enemy is currently on is different from the node they were on last timed check, update the old node to
-	// say the enemy is no longer there and update the node it is currently on to say there is an enemy on it
+	else if(m_targettingPlayer && !playerInRange)
+	{
+		m_targettingPlayer = false;
+		m_pathRequestTimer = 20.1f;
+	}
+
+	// The map invalidates the path when a tile anywhere on the rest of it changes, so a new path is only requested when
+	// this one is affected. This doesn't take into account if other terrain has changed which might provide a better path.
+	if(m_hasPath && !IsSearching() && m_path->IsInvalidated())
+		RequestPath(m_path->GetAlgoType());
+
+	// If the node the enemy is currently on is different from the node they were on last timed check, the enemy is counted off
+	// the old node and onto the one it is on now. The map applies the moves of every enemy together once per frame
 	if(m_map->GetNodeIndex(m_pos) != m_map->GetNodeIndex(m_prevPos))
 	{
 		m_map->RemoveEnemyFromNode(m_prevPos);
@@ -141,11 +115,24 @@ void Enemy::TimedUpdate()
 	}	
 }
 
-// Renders the enemy to the screen and draws its path if it has one
-void Enemy::Render()
+// Steers the enemy a tile at a time towards the player using the map's distance field. Every enemy chasing the
+// player shares the same field, so the only work done here is looking up the next tile
+void Enemy::ChasePlayer()
 {
-	al_draw_bitmap(m_sprite, m_pos.x - m_spriteWidth / 2, m_pos.y - m_spriteHeight / 2, 0);
+	DistanceField *field = m_map->GetDistanceField(m_player->GetPosition(), m_isPlayer);
+	glm::vec2 nextPoint = field->GetNextPoint(m_pos);
+
+	// Once the enemy is on the same tile as the player it heads straight for them
+	if(m_map->GetNodeIndex(m_pos) == field->GetTargetIndex())
+		nextPoint = m_player->GetPosition();
+
+	// If there is no way to reach the player the enemy stops chasing them
+	else if(nextPoint == glm::vec2(-1,-1))
+	{
+		m_targettingPlayer = false;
+		return;
+	}
 
-	if(m_path != nullptr)
-		m_path->DrawPath();
+	if(nextPoint != m_pos)
+		SteerTowards(nextPoint);
 }
\ No newline at end of file
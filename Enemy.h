@@ -4,6 +4,11 @@
 #include "BaseEntity.h"
 #include "Player.h"
 
+// Distance from an enemy the player has to come within for the enemy to start chasing them
+const float c_chaseRange = 200.0f;
+
+// Closest a new random target can be to where the enemy is standing
+const float c_minTargetDistance = 100.0f;
 
 class Enemy : public BaseEntity
 {
@@ -18,11 +23,11 @@ class Enemy : public BaseEntity
 		void SetDestination(glm::vec2 _dest);
 
 		void GenerateRandomTarget();
+		void ChasePlayer();
 
 		// Functions implemented by this class
 		virtual void Update();
 		virtual void TimedUpdate();
-		virtual void Render();		
 
 	private:
 		bool m_targettingPlayer;
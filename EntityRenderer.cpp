@@ -0,0 +1,38 @@
+#include "EntityRenderer.h"
+
+// Constructor - loads the sprites
+EntityRenderer::EntityRenderer()
+{
+	m_playerSprite = al_load_bitmap("Stickman.png");
+	m_goalSprite = al_load_bitmap("Goal.png");
+	m_enemySprite = al_load_bitmap("Enemy.png");
+}
+
+// Destructor - cleans up necessary objects to prevent memory leaks
+EntityRenderer::~EntityRenderer()
+{
+	al_destroy_bitmap(m_playerSprite);
+	al_destroy_bitmap(m_goalSprite);
+	al_destroy_bitmap(m_enemySprite);
+}
+
+// Renders the player and its destination (if it has one) to the screen
+void EntityRenderer::DrawPlayer(Player *_player)
+{
+	DrawSprite(m_playerSprite, _player->GetPosition());
+
+	if(_player->HasDestination())
+		DrawSprite(m_goalSprite, _player->GetDestination());
+}
+
+// Renders the enemy to the screen
+void EntityRenderer::DrawEnemy(Enemy *_enemy) { DrawSprite(m_enemySprite, _enemy->GetPosition()); }
+
+// Draws a sprite centred on the given position
+void EntityRenderer::DrawSprite(ALLEGRO_BITMAP *_sprite, glm::vec2 _pos)
+{
+	float width = al_get_bitmap_width(_sprite);
+	float height = al_get_bitmap_height(_sprite);
+
+	al_draw_bitmap(_sprite, _pos.x - width / 2, _pos.y - height / 2, 0);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef ENTITYRENDERER_H
+#define ENTITYRENDERER_H
+
+#include <allegro5\allegro.h>
+#include "Player.h"
+#include "Enemy.h"
+
+// Draws the player, its goal and the enemies with Allegro. The entities only hold their positions, so the
+// sprites are loaded once here rather than by every entity
+class EntityRenderer
+{
+	public:
+		// Constructor and destructor
+		EntityRenderer();
+		~EntityRenderer();
+
+		void DrawPlayer(Player *_player);
+		void DrawEnemy(Enemy *_enemy);
+
+	private:
+		void DrawSprite(ALLEGRO_BITMAP *_sprite, glm::vec2 _pos);
+
+		ALLEGRO_BITMAP *m_playerSprite;
+		ALLEGRO_BITMAP *m_goalSprite;
+		ALLEGRO_BITMAP *m_enemySprite;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "JumpPointSearch.h"
+#include "Map.h"
+#include "OccupancyMap.h"
+#include <algorithm>
+
+// Slot in the jump table used by each straight direction (-1 for diagonal directions)
+static const int c_jumpSlots[NUM_DIRECTIONS] = { -1, 0, -1, 1, 2, -1, 3, -1 };
+
+// The straight directions that make up each diagonal direction
+static const int c_diagHorizontal[NUM_DIRECTIONS] = { DIR_WEST, -1, DIR_EAST, -1, -1, DIR_WEST, -1, DIR_EAST };
+static const int c_diagVertical[NUM_DIRECTIONS] = { DIR_NORTH, -1, DIR_NORTH, -1, -1, DIR_SOUTH, -1, DIR_SOUTH };
+
+// Constructor - initialises member variables and builds the jump table for the map
+JumpPointSearch::JumpPointSearch(Map *_map)
+{
+	m_map = _map;
+
+	RebuildJumpTable();
+}
+
+// Destructor
+JumpPointSearch::~JumpPointSearch() {}
+
+// Runs jump point search from the start node until the end node is closed. Returns whether the end node was
+// reached, in which case the parents on the context lead from it back to the start through each jump point. Jump
+// points are ordered by the map's A Star heuristic, so the two searches estimate the cost to the end the same way
+bool JumpPointSearch::FindPath(SearchContext &_context, OpenList *_openList, int _startIndex, int _endIndex, bool _isPlayer, bool _useJumpTable, int &_numOps)
+{
+	_context.SetSearchState(_startIndex, NODE_OPEN);
+	_context.SetCosts(_startIndex, 0.0f, m_map->Heuristic(_startIndex, _endIndex));
+	_context.SetParent(_startIndex, -1);
+	_openList->Push(_startIndex, _context.GetFCost(_startIndex));
+
+	while(!_openList->IsEmpty())
+	{
+		int currIndex = _openList->PopLowest();
+
+		_context.SetSearchState(currIndex, NODE_CLOSED);
+
+		_numOps++;
+
+		if(currIndex == _endIndex)
+			return true;
+
+		int parentIndex = _context.GetParent(currIndex);
+		unsigned char dirMask = m_map->GetNeighbourMask(currIndex);
+
+		// Inside a uniform area only the natural neighbours in the direction of travel are searched. The start
+		// node and nodes on a boundary search every direction they can move in
+		if(parentIndex != -1 && m_uniform[currIndex])
+		{
+			int dx = (currIndex % m_numXTiles) - (parentIndex % m_numXTiles);
+			int dy = (currIndex / m_numXTiles) - (parentIndex / m_numXTiles);
+			dx = (dx > 0) - (dx < 0);
+			dy = (dy > 0) - (dy < 0);
+
+			unsigned char naturalMask = 0;
+
+			for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+			{
+				// A straight move keeps its direction and a diagonal move also keeps both of its straight parts
+				if((c_dirX[dir] == dx && c_dirY[dir] == dy) || (dx != 0 && dy != 0 && ((c_dirX[dir] == dx && c_dirY[dir] == 0) || (c_dirX[dir] == 0 && c_dirY[dir] == dy))))
+					naturalMask |= 1 << dir;
+			}
+
+			dirMask &= naturalMask;
+		}
+
+		float currGCost = _context.GetGCost(currIndex);
+
+		for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
+		{
+			if(!(dirMask & (1 << dir)))
+				continue;
+
+			int steps = 0;
+			int jumpIndex;
+
+			if(IsDiagonal(dir))
+				jumpIndex = JumpDiagonal(currIndex, dir, _endIndex, _useJumpTable, steps);
+			else
+				jumpIndex = JumpStraight(currIndex, dir, _endIndex, _useJumpTable, steps);
+
+			if(jumpIndex == -1)
+				continue;
+
+			int jumpState = _context.GetSearchState(jumpIndex);
+
+			if(jumpState == NODE_CLOSED)
+				continue;
+
+			float tempGCost = currGCost + GetJumpCost(currIndex, dir, steps, _isPlayer);
+
+			if(jumpState == NODE_OPEN && tempGCost >= _context.GetGCost(jumpIndex))
+				continue;
+
+			float tempFCost = tempGCost + m_map->Heuristic(jumpIndex, _endIndex);
+
+			_context.SetCosts(jumpIndex, tempGCost, tempFCost);
+			_context.SetParent(jumpIndex, currIndex);
+
+			if(jumpState == NODE_OPEN)
+				_openList->DecreaseKey(jumpIndex, tempFCost);
+
+			else
+			{
+				_context.SetSearchState(jumpIndex, NODE_OPEN);
+				_openList->Push(jumpIndex, tempFCost);
+			}
+		}
+	}
+
+	return false;
+}
+
+// Recalculates whether every node is uniform and the jump distances for the whole map
+void JumpPointSearch::RebuildJumpTable()
+{
+	m_numXTiles = m_map->GetNumXTiles();
+	m_numYTiles = m_map->GetNumYTiles();
+
+	m_uniform.assign(m_numXTiles * m_numYTiles, 0);
+	m_jumpDistances.assign(m_numXTiles * m_numYTiles * 4, 0);
+
+	for(int n = 0; n < m_numXTiles * m_numYTiles; n++)
+		m_uniform[n] = CalcUniform(n);
+
+	for(int y = 0; y < m_numYTiles; y++)
+		UpdateRowJumps(y);
+
+	for(int x = 0; x < m_numXTiles; x++)
+		UpdateColumnJumps(x);
+}
+
+// Updates the table after the nodes within the given radius of a tile have changed. Only nodes within one
+// tile of a changed node can change whether they are uniform, and only the rows and columns through those
+// nodes can have their jump distances changed
+void JumpPointSearch::UpdateJumpTable(int _tileX, int _tileY, int _radius)
+{
+	int minX = max(_tileX - _radius - 1, 0);
+	int maxX = min(_tileX + _radius + 1, m_numXTiles - 1);
+	int minY = max(_tileY - _radius - 1, 0);
+	int maxY = min(_tileY + _radius + 1, m_numYTiles - 1);
+
+	for(int y = minY; y <= maxY; y++)
+	{
+		for(int x = minX; x <= maxX; x++)
+			m_uniform[y * m_numXTiles + x] = CalcUniform(y * m_numXTiles + x);
+
+		UpdateRowJumps(y);
+	}
+
+	for(int x = minX; x <= maxX; x++)
+		UpdateColumnJumps(x);
+}
+
+// Returns whether the node and all of its neighbours are traversable, share the same terrain cost and have no
+// extra cost from the entities around them. Nodes on the edge of the map are never uniform as they are missing neighbours
+bool JumpPointSearch::CalcUniform(int _nodeIndex)
+{
+	int tileX = _nodeIndex % m_numXTiles;
+	int tileY = _nodeIndex / m_numXTiles;
+
+	if(tileX == 0 || tileY == 0 || tileX == m_numXTiles - 1 || tileY == m_numYTiles - 1)
+		return false;
+
+	float terrainCost = m_map->GetNode(_nodeIndex).GetTileCost();
+	OccupancyMap *occupancy = m_map->GetOccupancy();
+
+	for(int y = tileY - 1; y <= tileY + 1; y++)
+	{
+		for(int x = tileX - 1; x <= tileX + 1; x++)
+		{
+			Node &node = m_map->GetNode(y * m_numXTiles + x);
+
+			if(!node.IsTraversable() || node.GetTileCost() != terrainCost || occupancy->GetCostScale(y * m_numXTiles + x) != 1.0f)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Recalculates the east and west jump distances along a row. A positive distance is the number of steps to the
+// next node that is not uniform. Otherwise its negative is the number of steps that can be taken before
+// reaching an obstacle or the edge of the map
+void JumpPointSearch::UpdateRowJumps(int _tileY)
+{
+	int rowStart = _tileY * m_numXTiles;
+	int eastSlot = c_jumpSlots[DIR_EAST];
+	int westSlot = c_jumpSlots[DIR_WEST];
+
+	for(int x = m_numXTiles - 1; x >= 0; x--)
+	{
+		int nextIndex = rowStart + x + 1;
+		short distance = 0;
+
+		if(x + 1 < m_numXTiles && m_map->GetNode(nextIndex).IsTraversable())
+		{
+			short nextDistance = m_jumpDistances[nextIndex * 4 + eastSlot];
+			distance = !m_uniform[nextIndex] ? 1 : (nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+		}
+
+		m_jumpDistances[(rowStart + x) * 4 + eastSlot] = distance;
+	}
+
+	for(int x = 0; x < m_numXTiles; x++)
+	{
+		int nextIndex = rowStart + x - 1;
+		short distance = 0;
+
+		if(x - 1 >= 0 && m_map->GetNode(nextIndex).IsTraversable())
+		{
+			short nextDistance = m_jumpDistances[nextIndex * 4 + westSlot];
+			distance = !m_uniform[nextIndex] ? 1 : (nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+		}
+
+		m_jumpDistances[(rowStart + x) * 4 + westSlot] = distance;
+	}
+}
+
+// Recalculates the north and south jump distances along a column (see UpdateRowJumps)
+void JumpPointSearch::UpdateColumnJumps(int _tileX)
+{
+	int southSlot = c_jumpSlots[DIR_SOUTH];
+	int northSlot = c_jumpSlots[DIR_NORTH];
+
+	for(int y = m_numYTiles - 1; y >= 0; y--)
+	{
+		int nextIndex = (y + 1) * m_numXTiles + _tileX;
+		short distance = 0;
+
+		if(y + 1 < m_numYTiles && m_map->GetNode(nextIndex).IsTraversable())
+		{
+			short nextDistance = m_jumpDistances[nextIndex * 4 + southSlot];
+			distance = !m_uniform[nextIndex] ? 1 : (nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+		}
+
+		m_jumpDistances[(y * m_numXTiles + _tileX) * 4 + southSlot] = distance;
+	}
+
+	for(int y = 0; y < m_numYTiles; y++)
+	{
+		int nextIndex = (y - 1) * m_numXTiles + _tileX;
+		short distance = 0;
+
+		if(y - 1 >= 0 && m_map->GetNode(nextIndex).IsTraversable())
+		{
+			short nextDistance = m_jumpDistances[nextIndex * 4 + northSlot];
+			distance = !m_uniform[nextIndex] ? 1 : (nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+		}
+
+		m_jumpDistances[(y * m_numXTiles + _tileX) * 4 + northSlot] = distance;
+	}
+}
+
+// Moves from the node in a straight line until reaching the end node or a node that is not uniform, which is
+// returned as the next jump point. Returns -1 if an obstacle is reached first
+int JumpPointSearch::JumpStraight(int _nodeIndex, int _dir, int _endIndex, bool _useJumpTable, int &_steps)
+{
+	if(_useJumpTable)
+	{
+		short distance = m_jumpDistances[_nodeIndex * 4 + c_jumpSlots[_dir]];
+		int freeSteps = distance > 0 ? distance : -distance;
+
+		// If the end node is on this line within reach it is the jump point
+		int dx = (_endIndex % m_numXTiles) - (_nodeIndex % m_numXTiles);
+		int dy = (_endIndex / m_numXTiles) - (_nodeIndex / m_numXTiles);
+		int endSteps = -1;
+
+		if(c_dirY[_dir] == 0 && dy == 0 && dx * c_dirX[_dir] > 0)
+			endSteps = dx * c_dirX[_dir];
+		else if(c_dirX[_dir] == 0 && dx == 0 && dy * c_dirY[_dir] > 0)
+			endSteps = dy * c_dirY[_dir];
+
+		if(endSteps != -1 && endSteps <= freeSteps)
+		{
+			_steps = endSteps;
+			return _endIndex;
+		}
+
+		if(distance <= 0)
+			return -1;
+
+		_steps = distance;
+		return _nodeIndex + distance * (c_dirY[_dir] * m_numXTiles + c_dirX[_dir]);
+	}
+
+	int currIndex = _nodeIndex;
+	_steps = 0;
+
+	while(m_map->GetNeighbourMask(currIndex) & (1 << _dir))
+	{
+		currIndex = m_map->GetNeighbourIndex(currIndex, _dir);
+		_steps++;
+
+		if(currIndex == _endIndex || !m_uniform[currIndex])
+			return currIndex;
+	}
+
+	return -1;
+}
+
+// Moves from the node diagonally until reaching the end node, a node that is not uniform or a node that can
+// reach a jump point by moving along either straight part of the diagonal. Returns -1 if an obstacle is
+// reached first
+int JumpPointSearch::JumpDiagonal(int _nodeIndex, int _dir, int _endIndex, bool _useJumpTable, int &_steps)
+{
+	int currIndex = _nodeIndex;
+	int straightSteps;
+	_steps = 0;
+
+	while(m_map->GetNeighbourMask(currIndex) & (1 << _dir))
+	{
+		currIndex = m_map->GetNeighbourIndex(currIndex, _dir);
+		_steps++;
+
+		if(currIndex == _endIndex || !m_uniform[currIndex])
+			return currIndex;
+
+		if(JumpStraight(currIndex, c_diagHorizontal[_dir], _endIndex, _useJumpTable, straightSteps) != -1 ||
+			JumpStraight(currIndex, c_diagVertical[_dir], _endIndex, _useJumpTable, straightSteps) != -1)
+			return currIndex;
+	}
+
+	return -1;
+}
+
+// Returns the cost of jumping the given number of steps from the node. Every node after the first step of a
+// jump longer than one step is uniform, so the remaining steps all cost the same as the second one
+float JumpPointSearch::GetJumpCost(int _nodeIndex, int _dir, int _steps, bool _isPlayer)
+{
+	int firstIndex = m_map->GetNeighbourIndex(_nodeIndex, _dir);
+	float cost = m_map->GetMoveCost(_nodeIndex, firstIndex, _isPlayer);
+
+	if(_steps > 1)
+		cost += (_steps - 1) * m_map->GetMoveCost(firstIndex, m_map->GetNeighbourIndex(firstIndex, _dir), _isPlayer);
+
+	return cost;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef JUMPPOINTSEARCH_H
+#define JUMPPOINTSEARCH_H
+
+#include <vector>
+#include "SearchContext.h"
+
+class Map;
+
+// Jump point search over the map. A node is uniform when it and all eight of its neighbours are traversable,
+// have the same terrain cost and are not next to an enemy. Inside uniform areas all the paths between two
+// nodes cost the same, so the search only expands the natural neighbours and jumps in straight lines until
+// it reaches a node that is not uniform. Cost boundaries and obstacles are therefore treated the same way
+// forced neighbours are in the original algorithm and every node on a boundary is fully expanded.
+//
+// The precomputed version stores, for each node and straight direction, how far it is to the next node that
+// is not uniform or to the next obstacle. Diagonal jumps use these distances for their straight sub-jumps.
+// Because only straight distances are stored, a change to a tile only affects the rows and columns that
+// pass near it
+class JumpPointSearch
+{
+	public:
+		// Constructor and destructor
+		JumpPointSearch(Map *_map);
+		~JumpPointSearch();
+
+		bool FindPath(SearchContext &_context, OpenList *_openList, int _startIndex, int _endIndex, bool _isPlayer, bool _useJumpTable, int &_numOps);
+
+		void RebuildJumpTable();
+		void UpdateJumpTable(int _tileX, int _tileY, int _radius);
+
+	private:
+		bool CalcUniform(int _nodeIndex);
+		void UpdateRowJumps(int _tileY);
+		void UpdateColumnJumps(int _tileX);
+
+		int JumpStraight(int _nodeIndex, int _dir, int _endIndex, bool _useJumpTable, int &_steps);
+		int JumpDiagonal(int _nodeIndex, int _dir, int _endIndex, bool _useJumpTable, int &_steps);
+		float GetJumpCost(int _nodeIndex, int _dir, int _steps, bool _isPlayer);
+
+		int m_numXTiles, m_numYTiles;
+
+		std::vector<unsigned char> m_uniform;
+		std::vector<short> m_jumpDistances;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
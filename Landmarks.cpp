@@ -0,0 +1,151 @@
+#include "Landmarks.h"
+#include "DistanceField.h"
+#include "Map.h"
+#include <limits>
+
+static const float c_infinity = std::numeric_limits<float>::infinity();
+
+// Constructor - initialises member variables and picks the landmarks for the map
+Landmarks::Landmarks(Map *_map, int _numLandmarks)
+{
+	m_map = _map;
+	m_numLandmarks = _numLandmarks;
+
+	SelectLandmarks();
+}
+
+// Destructor - cleans up necessary objects to prevent memory leaks
+Landmarks::~Landmarks() { ClearLandmarks(); }
+
+// Getters
+
+int Landmarks::GetNumLandmarks() { return m_landmarkIndices.size(); }
+int Landmarks::GetLandmarkIndex(int _landmark) { return m_landmarkIndices[_landmark]; }
+
+// Returns a lower bound on the cost from the node to the end. It is the largest of the scaled distance between
+// them and, for each landmark both can reach, how much further the node is from the landmark than the end is,
+// and how much further the landmark is from the end than from the node
+float Landmarks::Heuristic(int _nodeIndex, int _endIndex)
+{
+	float bound = m_map->DistBetweenNodes(m_map->GetNode(_nodeIndex), m_map->GetNode(_endIndex)) * c_minCostPerDistance;
+
+	for(unsigned int i = 0; i < m_landmarkIndices.size(); i++)
+	{
+		float nodeTo = m_toFields[i]->GetDistance(_nodeIndex);
+		float endTo = m_toFields[i]->GetDistance(_endIndex);
+
+		if(nodeTo != c_infinity && endTo != c_infinity && nodeTo - endTo > bound)
+			bound = nodeTo - endTo;
+
+		float nodeFrom = m_fromFields[i]->GetDistance(_nodeIndex);
+		float endFrom = m_fromFields[i]->GetDistance(_endIndex);
+
+		if(nodeFrom != c_infinity && endFrom != c_infinity && endFrom - nodeFrom > bound)
+			bound = endFrom - nodeFrom;
+	}
+
+	return bound;
+}
+
+// Setters
+
+// Repairs the tables after the map has changed. If a landmark can no longer be walked on new ones are picked
+void Landmarks::Update()
+{
+	for(int landmarkIndex : m_landmarkIndices)
+	{
+		if(!m_map->GetNode(landmarkIndex).IsTraversable())
+		{
+			SelectLandmarks();
+			return;
+		}
+	}
+
+	for(unsigned int i = 0; i < m_landmarkIndices.size(); i++)
+	{
+		glm::vec2 landmarkPos = m_map->GetNode(m_landmarkIndices[i]).GetPos();
+
+		m_toFields[i]->Update(landmarkPos);
+		m_fromFields[i]->Update(landmarkPos);
+	}
+}
+
+// Picks landmarks that are as far apart as possible. The first is the tile furthest from the first traversable
+// tile on the map, and each one after that is the tile whose cost to the nearest landmark picked so far is highest
+void Landmarks::SelectLandmarks()
+{
+	ClearLandmarks();
+
+	int numNodes = m_map->GetNumNodes();
+	int firstIndex = 0;
+
+	while(firstIndex < numNodes && !m_map->GetNode(firstIndex).IsTraversable())
+		firstIndex++;
+
+	if(firstIndex == numNodes)
+		return;
+
+	DistanceField firstField(m_map, false);
+	firstField.Update(m_map->GetNode(firstIndex).GetPos());
+
+	std::vector<float> nearestCosts(numNodes, c_infinity);
+	int nextIndex = firstIndex;
+
+	for(int n = 0; n < numNodes; n++)
+	{
+		if(firstField.GetDistance(n) != c_infinity && firstField.GetDistance(n) > firstField.GetDistance(nextIndex))
+			nextIndex = n;
+	}
+
+	while((int)m_landmarkIndices.size() < m_numLandmarks)
+	{
+		AddLandmark(nextIndex);
+
+		// Finds the tile furthest from every landmark picked so far. Tiles that can't reach a landmark are left
+		// out so a landmark isn't wasted on a closed off area
+		DistanceField *newField = m_toFields.back();
+		float furthestCost = 0.0f;
+
+		for(int n = 0; n < numNodes; n++)
+		{
+			if(newField->GetDistance(n) < nearestCosts[n])
+				nearestCosts[n] = newField->GetDistance(n);
+
+			if(nearestCosts[n] != c_infinity && nearestCosts[n] > furthestCost)
+			{
+				furthestCost = nearestCosts[n];
+				nextIndex = n;
+			}
+		}
+
+		if(furthestCost == 0.0f)
+			break;
+	}
+}
+
+// Deletes the tables of every landmark
+void Landmarks::ClearLandmarks()
+{
+	for(DistanceField *field : m_toFields)
+		delete field;
+
+	for(DistanceField *field : m_fromFields)
+		delete field;
+
+	m_landmarkIndices.clear();
+	m_toFields.clear();
+	m_fromFields.clear();
+}
+
+// Adds a landmark at the given node and builds its tables
+void Landmarks::AddLandmark(int _nodeIndex)
+{
+	glm::vec2 landmarkPos = m_map->GetNode(_nodeIndex).GetPos();
+
+	m_landmarkIndices.push_back(_nodeIndex);
+	m_toFields.push_back(new DistanceField(m_map, false));
+	m_fromFields.push_back(new DistanceField(m_map, false, true));
+
+	m_toFields.back()->Update(landmarkPos);
+	m_fromFields.back()->Update(landmarkPos);
+}
\ No newline at end of file
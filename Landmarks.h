@@ -0,0 +1,48 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+
+class Map;
+class DistanceField;
+
+// Number of landmarks picked for the A Star heuristic
+const int c_numLandmarks = 8;
+
+// Landmark heuristic for A Star. A few tiles spread as far apart as possible are picked as landmarks and a
+// distance field is kept towards and away from each of them. By the triangle inequality the cost between two
+// tiles is at least the difference between their costs to or from any landmark, which unlike the distance
+// between them takes the terrain in the way into account.
+//
+// The tables use the costs an enemy sees. The player's costs are never lower, so the bounds hold for both and
+// enemies moving don't change the tables. Tables are repaired from the map's change log whenever a tile changes
+class Landmarks
+{
+	public:
+		// Constructor and destructor
+		Landmarks(Map *_map, int _numLandmarks = c_numLandmarks);
+		~Landmarks();
+
+		// Getters
+		int GetNumLandmarks();
+		int GetLandmarkIndex(int _landmark);
+		float Heuristic(int _nodeIndex, int _endIndex);
+
+		// Setters
+		void Update();
+
+	private:
+		void SelectLandmarks();
+		void ClearLandmarks();
+		void AddLandmark(int _nodeIndex);
+
+		int m_numLandmarks;
+
+		std::vector<int> m_landmarkIndices;
+		std::vector<DistanceField*> m_toFields;
+		std::vector<DistanceField*> m_fromFields;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
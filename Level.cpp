@@ -1,7 +1,8 @@
 #include "Level.h"
+#include "PathCache.h"
 
 // Constructor - initialises member variables
-Level::Level(GamestateManager *_stateManager)
+Level::Level(GamestateManager *_stateManager, bool _headless)
 {
 	m_mapWidth = 1000;
 	m_mapHeight = 1000;
@@ -18,11 +19,32 @@ Level::Level(GamestateManager *_stateManager)
 
 	m_currTileType = -1;
 	m_mouseDown = false;
-	m_paused = true;
-	m_enemiesActive = false;
+	m_headless = _headless;
 
 	m_activeTileType = "";
 	m_algoMessage = "";
+
+	// A headless level runs the enemies straight away as there is no input to start them
+	if(m_headless)
+	{
+		m_paused = false;
+		m_enemiesActive = true;
+
+		m_mapRenderer = nullptr;
+		m_pathRenderer = nullptr;
+		m_entityRenderer = nullptr;
+		m_font = nullptr;
+		m_eventQueue = nullptr;
+
+		return;
+	}
+
+	m_paused = true;
+	m_enemiesActive = false;
+
+	m_mapRenderer = new MapRenderer(m_map);
+	m_pathRenderer = new PathRenderer();
+	m_entityRenderer = new EntityRenderer();
 	m_font = al_load_font("Arial.ttf", 14, 0);
 
 	// Creates the event queue used for getting keyboard input and registers the keyboard
@@ -34,20 +56,44 @@ Level::Level(GamestateManager *_stateManager)
 // Destructor - cleans up necessary objects to prevent memory leaks
 Level::~Level()
 {
-	delete m_map;
+	// The entities cancel their path requests on the map, so they are deleted before it
 	delete m_player;
 	for(Enemy* enemy : m_enemies)
 	{
 		delete(enemy);
 	}
 	m_enemies.clear();
-	al_destroy_font(m_font);
+	delete m_map;
+
+	if(!m_headless)
+	{
+		delete m_mapRenderer;
+		delete m_pathRenderer;
+		delete m_entityRenderer;
+		al_destroy_font(m_font);
+		al_destroy_event_queue(m_eventQueue);
+	}
 }
 
 // Update function that is called every game loop - processes player input and performs the
 // necessary actions
 bool Level::Update()
 {
+	// A headless level only moves the entities
+	if(m_headless)
+	{
+		m_player->Update();
+
+		for(Enemy* enemy : m_enemies)
+		{
+			enemy->Update();
+		}
+
+		m_map->UpdateOccupancy();
+
+		return gameRunning;
+	}
+
 	// Gets the next event in the queue
 	al_get_next_event(m_eventQueue, &m_event);
 
@@ -90,12 +136,12 @@ bool Level::Update()
 					break;
 			case ALLEGRO_KEY_G:
 				{
-					m_map->ToggleGrid();
+					m_mapRenderer->ToggleGrid();
 				}
 					break;
 			case ALLEGRO_KEY_V:
 				{
-					m_map->ToggleTileVals();
+					m_mapRenderer->ToggleTileVals();
 				}
 					break;
 			case ALLEGRO_KEY_S:
@@ -151,6 +197,71 @@ bool Level::Update()
 						m_algoMessage = "No end point specified";
 				}
 				break;
+			case ALLEGRO_KEY_J:
+				{
+					if(m_player->HasDestination())
+					{
+						m_map->UpdateEdgeList();
+						m_player->ClearPath();
+						m_player->RequestPath(ALGO_JUMP_POINT);
+					}
+
+					else
+						m_algoMessage = "No end point specified";
+				}
+				break;
+			case ALLEGRO_KEY_H:
+				{
+					if(m_player->HasDestination())
+					{
+						m_map->UpdateEdgeList();
+						m_player->ClearPath();
+						m_player->RequestPath(ALGO_HIERARCHICAL);
+					}
+
+					else
+						m_algoMessage = "No end point specified";
+				}
+				break;
+			case ALLEGRO_KEY_L:
+				{
+					if(m_player->HasDestination())
+					{
+						m_map->UpdateEdgeList();
+						m_player->ClearPath();
+						m_player->RequestPath(ALGO_D_STAR_LITE);
+					}
+
+					else
+						m_algoMessage = "No end point specified";
+				}
+				break;
+			case ALLEGRO_KEY_B:
+				{
+					if(m_player->HasDestination())
+					{
+						m_map->UpdateEdgeList();
+						m_player->ClearPath();
+						m_player->RequestPath(ALGO_BIDIRECTIONAL_A_STAR);
+					}
+
+					else
+						m_algoMessage = "No end point specified";
+				}
+				break;
+			case ALLEGRO_KEY_N:
+				{
+					if(m_player->HasDestination())
+					{
+						m_map->UpdateEdgeList();
+						m_player->ClearPath();
+						m_player->RequestPath(ALGO_BIDIRECTIONAL_DIJKSTRA);
+					}
+
+					else
+						m_algoMessage = "No end point specified";
+				}
+				break;
 			case ALLEGRO_KEY_Z:
 				{
 					m_enemiesActive = !m_enemiesActive;
@@ -205,6 +316,9 @@ bool Level::Update()
 				enemy->Update();
 			}
 		}
+
+		// The enemies' moves this frame are applied to the map's costs together
+		m_map->UpdateOccupancy();
 	}
 
 	// Returns whether the game still needs to be run or not to the gamestate manager
@@ -214,7 +328,10 @@ bool Level::Update()
 // Renders all necessary information to the screen and calls the render function of the map, player and enemies
 void Level::Render()
 {
-	m_map->DrawMap();
+	if(m_headless)
+		return;
+
+	m_mapRenderer->DrawMap();
 
 	al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 20, 0, "Selected tile type: %s", m_activeTileType.c_str());
 	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 35, 0, "Press 1 to choose GRASS tile");
@@ -232,23 +349,31 @@ void Level::Render()
 	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 225, 0, "Press Z to toggle enemies");
 	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 240, 0, "Press P to pause/unpause player movement");
 
+	al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 270, 0, "Path cache hit rate: %.0f%% (%i evictions)", m_map->GetPathCache()->GetHitRate() * 100.0f, m_map->GetPathCache()->GetNumEvictions());
 	al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 300, 0, "Diagonal moves allowed: %i", m_map->DiagsAllowed());
 
 	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 325, 0, "Press A to generate an A Star path");
 	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 340, 0, "Press D to generate a Dijkstra path");
-	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 355, 0, "Press C to clear the path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 355, 0, "Press J to generate a Jump Point Search path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 370, 0, "Press H to generate a Hierarchical A Star path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 385, 0, "Press L to generate a D* Lite path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 400, 0, "Press B to generate a Bidirectional A Star path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 415, 0, "Press N to generate a Bidirectional Dijkstra path");
+	al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 430, 0, "Press C to clear the path");
 
 	if(m_paused)
-		al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 500, 0, "PAUSED");
+		al_draw_text(m_font, al_map_rgb(0,0,0), 1020, 530, 0, "PAUSED");
 
-	// Draw player and enemies
-	m_player->Render();
+	// Draw player and enemies along with their paths
+	m_entityRenderer->DrawPlayer(m_player);
+	m_pathRenderer->DrawPath(m_player->GetPath());
 
 	if(m_enemiesActive)
 	{
 		for(Enemy* enemy : m_enemies)
 		{
-			enemy->Render();
+			m_entityRenderer->DrawEnemy(enemy);
+			m_pathRenderer->DrawPath(enemy->GetPath());
 		}
 	}
 }
\ No newline at end of file
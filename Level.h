@@ -4,6 +4,9 @@
 #include "Map.h"
 #include "Player.h"
 #include "Enemy.h"
+#include "MapRenderer.h"
+#include "PathRenderer.h"
+#include "EntityRenderer.h"
 #include "allegro5\allegro.h"
 #include <allegro5\allegro_font.h>
 #include <string>
@@ -14,8 +17,9 @@ class GamestateManager;
 class Level : public Gamestate
 {
 	public:
-		// Constructor and destructor
-		Level(GamestateManager *_stateManager);
+		// Constructor and destructor. A headless level takes no input and draws nothing, so it can be run
+		// without Allegro being initialised
+		Level(GamestateManager *_stateManager, bool _headless = false);
 		~Level();
 
 		// Inherited functions to be defined by this class
@@ -27,6 +31,7 @@ class Level : public Gamestate
 		int m_mapWidth, m_mapHeight;
 
 		bool m_mouseDown, m_paused, m_enemiesActive;
+		bool m_headless;
 
 		GamestateManager *m_stateManager;
 
@@ -34,6 +39,10 @@ class Level : public Gamestate
 		Player *m_player;
 		std::vector<Enemy*> m_enemies;
 
+		MapRenderer *m_mapRenderer;
+		PathRenderer *m_pathRenderer;
+		EntityRenderer *m_entityRenderer;
+
 		std::string m_activeTileType;
 		std::string m_algoMessage;
 
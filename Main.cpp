@@ -1,10 +1,40 @@
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
 #include "AllegroInit.h"
 #include "Level.h"
 #include "GamestateManager.h"
 
-int main()
+// Number of frames a headless run simulates if none are given
+const int c_defaultHeadlessFrames = 1800;
+
+// Runs the simulation without Allegro as fast as it can for the given number of frames and prints how long it took
+int RunHeadless(int _numFrames)
+{
+	GamestateManager stateManager;
+	stateManager.AddState(new Level(&stateManager, true));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	int frame = 0;
+
+	while(frame < _numFrames && stateManager.Update())
+		frame++;
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Simulated " << frame << " frames in " << seconds << " seconds" << std::endl;
+
+	return 0;
+}
+
+// Usage: [--headless [frames]]
+int main(int argc, char *argv[])
 {
+	if(argc > 1 && std::string(argv[1]) == "--headless")
+		return RunHeadless(argc > 2 ? std::atoi(argv[2]) : c_defaultHeadlessFrames);
+
 	// Loads and initialises Allegro
 	AllegroInit allegro;
 
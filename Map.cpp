@@ -1,49 +1,151 @@
 #include "Map.h"
+#include "JumpPointSearch.h"
+#include "ClusterGraph.h"
+#include "BidirectionalSearch.h"
+#include "DistanceField.h"
+#include "Landmarks.h"
+#include "DStarLite.h"
+#include "ThreadPool.h"
+#include "PathQueue.h"
+#include "PathCache.h"
+#include "PathWatcher.h"
+#include "MapFile.h"
+#include "ChunkStore.h"
+#include "ConnectedComponents.h"
+#include "OccupancyMap.h"
+#include "SearchPolicies.h"
 #include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
 
-// Constructor - initialises member variables
-Map::Map(int _mapWidth, int _mapHeight)
+// Constructor - initialises member variables and loads the given map file
+Map::Map(int _mapWidth, int _mapHeight, string _mapFile)
 {
 	m_mapWidth = _mapWidth;
 	m_mapHeight = _mapHeight;
 
-	m_showGrid = true;
-	m_showTileVals = false;
+	m_mapNodes = NULL;
 	m_allowDiags = true;
+	m_activeDirs = c_orthogonalMask | c_diagonalMask;
+	m_edgesDirty = true;
+	m_useLandmarks = true;
+	m_mapVersion = 0;
+	m_terrainVersion = 0;
+	m_occupancy = NULL;
+	m_jumpPointSearch = NULL;
+	m_clusterGraph = NULL;
+	m_landmarks = NULL;
+	m_components = NULL;
+	m_threadPool = NULL;
+	m_pathQueue = NULL;
+	m_editsWaiting = 0;
+	m_distanceFields[0] = NULL;
+	m_distanceFields[1] = NULL;
+
+	m_changeLog.resize(c_changeLogSize);
+	m_changeLogHead = 0;
+	m_forgottenVersion = 0;
 	
-	m_baseTiles = al_load_bitmap("Base Tiles.png");
-	m_font = al_load_font("Arial.ttf", 14, 0);
-
 	// Loads the map data from the provided text file and updates the node links
 	// for each node in the map
-	LoadMap();
+	LoadMap(_mapFile);
 	UpdateEdgeList();
+
+	// The jump tables, cluster graph, connected components and landmarks each cover the whole map, so they are
+	// left until something uses them rather than built here
+	m_bidirectionalSearch = new BidirectionalSearch(this);
+	m_pathCache = new PathCache(m_numXTiles, m_numYTiles);
+	m_pathWatcher = new PathWatcher();
 }
 
 // Destructor - cleans up necessary objects to prevent memory leaks
 Map::~Map()
 {
-	al_destroy_bitmap(m_baseTiles);
-
-	for(int i = 0; i < m_numYTiles; ++i)
-	{
-		delete [] m_mapNodes[i];
-		delete [] m_nodeLinks[i];
-	}
-
-	delete [] m_mapNodes;
-	delete [] m_nodeLinks;
-	al_destroy_font(m_font);
+	// The queue's workers are stopped first as they read everything else
+	delete m_pathQueue;
+	delete m_jumpPointSearch.load();
+	delete m_clusterGraph.load();
+	delete m_bidirectionalSearch;
+	delete m_threadPool;
+	delete m_pathCache;
+	delete m_pathWatcher;
+	delete m_distanceFields[0];
+	delete m_distanceFields[1];
+	delete m_landmarks.load();
+	delete m_components.load();
+	delete m_occupancy;
+	delete m_mapNodes;
 }
 
 // Getters
 
 // Returns whether the node at the given position is traversable
-bool Map::IsPointTraversable(glm::vec2 &_point) { return m_mapNodes[(int)(_point.y / m_tileHeight)][(int)(_point.x / m_tileWidth)].IsTraversable(); }
+bool Map::IsPointTraversable(glm::vec2 &_point) { return GetNode(GetNodeIndex(_point)).IsTraversable(); }
 bool Map::DiagsAllowed() { return m_allowDiags; }
 
+// Returns whether A Star uses the landmark heuristic rather than the distance between nodes
+bool Map::LandmarksEnabled() { return m_useLandmarks; }
+
+// Returns the version of the map, which increases every time a node is changed
+unsigned int Map::GetMapVersion() { return m_mapVersion; }
+
+// Returns the version of the map at the last change to the costs of the given type of entity. Enemies don't
+// pay anything for the occupancy layer, so its changes don't move their version on
+unsigned int Map::GetCostVersion(bool _isPlayer) { return _isPlayer ? m_mapVersion : m_terrainVersion; }
+
 // Returns the index of the node at the given position
-int Map::GetNodeIndex(glm::vec2 _pos) {	return m_mapNodes[(int)(_pos.y / m_tileHeight)][(int)(_pos.x / m_tileWidth)].GetNodeIndex(); }
+int Map::GetNodeIndex(glm::vec2 _pos) {	return (int)(_pos.y / m_tileHeight) * m_numXTiles + (int)(_pos.x / m_tileWidth); }
+
+int Map::GetNumXTiles() { return m_numXTiles; }
+int Map::GetNumYTiles() { return m_numYTiles; }
+int Map::GetNumNodes() { return m_numXTiles * m_numYTiles; }
+int Map::GetNumLoadedChunks() { return m_mapNodes->GetNumLoadedChunks(); }
+float Map::GetTileWidth() { return m_tileWidth; }
+float Map::GetTileHeight() { return m_tileHeight; }
+
+// Returns the range of costs grouped together by the bucket open list
+float Map::GetBucketWidth() { return m_bucketWidth; }
+
+// Returns the node at the given index
+Node& Map::GetNode(int _nodeIndex) { return m_mapNodes->GetNode(_nodeIndex); }
+PathCache* Map::GetPathCache() { return m_pathCache; }
+
+// Returns the landmark tables, picking the landmarks and building their tables the first time they are asked for
+Landmarks* Map::GetLandmarks() { return BuildOnce(m_landmarks); }
+
+// Returns the connected components of the map, labelling the map the first time they are asked for
+ConnectedComponents* Map::GetComponents() { return BuildOnce(m_components); }
+
+OccupancyMap* Map::GetOccupancy() { return m_occupancy; }
+
+// Returns the mask of directions that can be moved in from the node at the given index
+unsigned char Map::GetNeighbourMask(int _nodeIndex) { return m_neighbourMasks[_nodeIndex] & m_activeDirs; }
+
+// Returns the index of the neighbour of the given node in the given direction. The direction must be in
+// the node's neighbour mask or the result may be off the map
+int Map::GetNeighbourIndex(int _nodeIndex, int _dir) { return _nodeIndex + m_dirOffsets[_dir]; }
+
+// Adds the index of every node that has changed since the given map version to the list. Returns false if
+// some of those changes are no longer in the change log, in which case the caller has to assume every node
+// may have changed
+bool Map::GetChangesSince(unsigned int _version, vector<int> &_changedNodes)
+{
+	if(_version < m_forgottenVersion)
+		return false;
+
+	for(int i = 1; i <= c_changeLogSize; i++)
+	{
+		MapChange &change = m_changeLog[(m_changeLogHead - i + c_changeLogSize) % c_changeLogSize];
+
+		if(change.version <= _version)
+			break;
+
+		_changedNodes.push_back(change.nodeIndex);
+	}
+
+	return true;
+}
 
 // Setters
 
@@ -51,456 +153,700 @@ int Map::GetNodeIndex(glm::vec2 _pos) {	return m_mapNodes[(int)(_pos.y / m_tileH
 // updates the links of the surrounding nodes
 void Map::ChangeTile(float _xPos, float _yPos, int _tileType)
 {
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
+
 	int tempX = _xPos / m_tileWidth;
 	int tempY = _yPos / m_tileHeight;
-	m_mapNodes[tempY][tempX].UpdateTerrain(_tileType);
+	bool wasTraversable = GetNode(tempY * m_numXTiles + tempX).IsTraversable();
+	GetNode(tempY * m_numXTiles + tempX).UpdateTerrain(_tileType, ++m_mapVersion);
+	m_terrainVersion = m_mapVersion;
+	LogChange(tempY * m_numXTiles + tempX);
+
+	// Only the links from the neighbouring nodes onto this one depend on whether it is traversable, so they are
+	// the only part of the neighbour masks that can change, and only if it has turned into or out of a hole
+	if(GetNode(tempY * m_numXTiles + tempX).IsTraversable() != wasTraversable)
+		UpdateLinksTo(tempY * m_numXTiles + tempX);
+
+	// The tables that haven't been built yet will be built from the changed map, so only the built ones are updated
+	JumpPointSearch *jumpPointSearch = m_jumpPointSearch.load();
+	ClusterGraph *clusterGraph = m_clusterGraph.load();
+	ConnectedComponents *components = m_components.load();
+
+	// Updates the jump point search data around the changed tile
+	if(jumpPointSearch != NULL)
+		jumpPointSearch->UpdateJumpTable(tempX, tempY, 0);
+
+	// Rebuilds the cluster containing the tile, and its neighbours if the tile is on a border that has opened or closed
+	if(clusterGraph != NULL)
+		clusterGraph->UpdateTile(tempX, tempY, wasTraversable != GetNode(tempY * m_numXTiles + tempX).IsTraversable());
+
+	// Joins or splits the connected components if the tile turned into or out of a hole
+	if(components != NULL)
+		components->UpdateTile(tempY * m_numXTiles + tempX, wasTraversable);
+
+	// Repairs the landmark tables around the changed tile
+	Landmarks *landmarks = m_landmarks.load();
+
+	if(landmarks != NULL)
+		landmarks->Update();
+}
 
-	// If the node being updated is not in the top row update the links for the nodes above it
-	if(tempY > 0)
+// Loads the map from the provided map file. Binary map files are memory-mapped and their tiles used directly,
+// and any other file is read as a text map. The nodes are split into chunks that are only created when they are
+// first used. A map that can't be read is left empty
+void Map::LoadMap(string _mapFile)
+{
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
+
+	MapFile *mapFile = new MapFile();
+	vector<int> textTiles;
+
+	if(mapFile->Open(_mapFile))
 	{
-		for(int n = tempX-1; n <= tempX+1; n++)
-		{
-			if(n >= 0 && n < m_numXTiles)
-			{
-				UpdateSingleNodeEdgeList(n, tempY-1);
-			}
-		}
+		m_numXTiles = mapFile->GetNumXTiles();
+		m_numYTiles = mapFile->GetNumYTiles();
 	}
 
-	// If the node being updated is not in the left-most column update the links for the nodes to the left of it
-	if(tempX > 0)
+	else
 	{
-		UpdateSingleNodeEdgeList(tempX-1, tempY);
+		delete mapFile;
+		mapFile = NULL;
+
+		if(!MapFile::ReadTextMap(_mapFile, m_numXTiles, m_numYTiles, textTiles))
+		{
+			m_numXTiles = 0;
+			m_numYTiles = 0;
+		}
 	}
 
-	// If the node being updated is not in right-most top row update the links for the nodes to the right of it
-	if(tempX < m_numXTiles - 1)
+	// Calculates the width and height of each tile based on the provided map file
+	m_tileWidth = m_mapWidth / (float)m_numXTiles;
+	m_tileHeight = m_mapHeight / (float)m_numYTiles;
+
+	// The bucket open list groups costs to a quarter of the cheapest move between two tiles
+	m_bucketWidth = min(m_tileWidth, m_tileHeight) * c_minCostPerDistance * 0.25f;
+
+	// The chunk store takes over the map file or the text tiles, and the neighbour masks record which adjacent
+	// nodes each node links to
+	delete m_mapNodes;
+	m_mapNodes = new ChunkStore(m_numXTiles, m_numYTiles, m_tileWidth, m_tileHeight, mapFile, textTiles);
+	m_neighbourMasks.assign(m_numXTiles * m_numYTiles, 0);
+	m_edgesDirty = true;
+
+	delete m_occupancy;
+	m_occupancy = new OccupancyMap(m_numXTiles, m_numYTiles);
+
+	// Stores how far away in the node array the neighbour in each direction is, and how far apart the centres
+	// of the two tiles are
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
 	{
-		UpdateSingleNodeEdgeList(tempX+1, tempY);
+		m_dirOffsets[dir] = c_dirY[dir] * m_numXTiles + c_dirX[dir];
+		m_dirLengths[dir] = glm::length(glm::vec2(c_dirX[dir] * m_tileWidth, c_dirY[dir] * m_tileHeight));
 	}
+}
 
-	// // If the node being updated is not in the bottom row update the links for the nodes below it
-	if( tempY < m_numYTiles - 1)
-	{
-		for(int n = tempX-1; n <= tempX+1; n++)
-		{
-			if(n >= 0 && n < m_numXTiles)
-			{
-				UpdateSingleNodeEdgeList(n, tempY+1);
-			}
-		}
-	}		
+// Switches diagonal moves on or off. The neighbour masks always hold the links in all eight directions and the
+// diagonal ones are masked out when they aren't allowed, so the masks themselves don't change
+void Map::ToggleDiags()
+{
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
+
+	m_allowDiags = !m_allowDiags;
+	m_activeDirs = m_allowDiags ? c_orthogonalMask | c_diagonalMask : c_orthogonalMask;
+
+	// Paths being followed may cut corners that can no longer be moved across
+	if(!m_allowDiags)
+		m_pathWatcher->InvalidateAll();
+
+	// Every cost found so far depends on whether diagonal moves were allowed, and the change log doesn't record
+	// the change, so everything built from the log is made to start again. This also makes the path cache
+	// treat every path in it as stale, as its keys don't say whether diagonals were allowed
+	m_forgottenVersion = ++m_mapVersion;
+	m_terrainVersion = m_mapVersion;
+
+	UpdateDiagDependents();
+
+	Landmarks *landmarks = m_landmarks.load();
+
+	if(landmarks != NULL)
+		landmarks->Update();
 }
 
-// Loads the data to populate the map nodes from the provided text file
-void Map::LoadMap()
+// Chooses whether A Star uses the landmark heuristic, which it does unless this turns it off. Without it A Star
+// uses the distance between nodes scaled by the cheapest terrain, which ignores the terrain in the way but needs
+// no tables. Paths already in the cache were found with the old heuristic, so they are cleared
+void Map::SetLandmarksEnabled(bool _enabled)
 {
-	std::ifstream inFile;
-	std::string inData;
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
 
-	// Opens the text file to read the map data
-	inFile.open("Base Map.txt");
+	if(_enabled != m_useLandmarks)
+		m_pathCache->Clear();
 
-	int numRows = 0;
-	int numColumns = 0;
+	m_useLandmarks = _enabled;
 
-	// Reads the data in the text file and counts how many rows of data there are
-	while (std::getline(inFile, inData))
+	// The tables hold two distance fields for each landmark, so they are thrown away while landmarks are turned
+	// off and built again by the next search that uses them
+	if(!_enabled)
 	{
-		numRows++;
+		delete m_landmarks.load();
+		m_landmarks = NULL;
 	}
+}
 
-	// Resets the stream point and reads one line of data
-	inFile.clear();
-	inFile.seekg(0);
+// Sets how much memory the loaded chunks of nodes can take up, with zero keeping every chunk that has been used
+// loaded. The budget is applied before each search, so a single search can go over it while it runs
+void Map::SetChunkMemoryBudget(size_t _bytes)
+{
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
 
-	std::getline(inFile, inData);
+	m_mapNodes->SetMemoryBudget(_bytes);
+	m_mapNodes->TrimToBudget();
+}
 
-	// Counts how many columns of data there are based on how many numbers are in the line of data
-	// This only works if the numbers are single digits
-	for (auto n : inData)
-	{
-		if (isdigit(n))
-			numColumns++;
-	}
+// Counts an enemy moving onto the node at the given position. The cost of the tiles around it changes with
+// the next call to UpdateOccupancy
+void Map::AddEnemyToNode(glm::vec2 _pos)
+{
+	m_occupancy->AddOccupant(GetNodeIndex(_pos));
+}
 
-	m_numXTiles = numColumns;
-	m_numYTiles = numRows;
+// Counts an enemy moving off the node at the given position
+void Map::RemoveEnemyFromNode(glm::vec2 _pos)
+{
+	m_occupancy->RemoveOccupant(GetNodeIndex(_pos));
+}
 
-	// Calculates the width and height of each tile based on the provided map file
-	m_tileWidth = m_mapWidth / (float)m_numXTiles;
-	m_tileHeight = m_mapHeight / (float)m_numYTiles;
+// Applies every enemy move made since the last update to the occupancy layer in one pass, and updates the data
+// built from the player's costs around the tiles whose cost changed. Only the player pays for the layer, so
+// only the player's cached paths are thrown out and the version enemy paths are checked against stays the same
+void Map::UpdateOccupancy()
+{
+	if(!m_occupancy->HasPendingChanges())
+		return;
 
-	int rowNum = 0;
-	int colNum = 0;
-	int tempInt = 0;
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
 
-	int tempCount = 0;
-	int counter = 0;
+	vector<int> changedSources;
+	vector<int> changedTiles;
+	int radius = m_occupancy->ApplyChanges(changedSources, changedTiles);
 
-	// Dynamically creates the 2D array of pointers to the nodes based on how big the map in the text file is
-	// Also creates the vectors of node links that contains each nodes' pointers to adjacent nodes
-	m_mapNodes = new Node*[numRows];
-	m_nodeLinks = new vector<Node*>*[numRows];
-	
-	for(int i = 0; i < numRows; i++)
+	if(changedTiles.empty())
+		return;
+
+	m_mapVersion++;
+
+	for(int nodeIndex : changedTiles)
+		LogChange(nodeIndex, true);
+
+	JumpPointSearch *jumpPointSearch = m_jumpPointSearch.load();
+	ClusterGraph *clusterGraph = m_clusterGraph.load();
+
+	for(int nodeIndex : changedSources)
 	{
-		m_mapNodes[i] = new Node[numColumns];
-		m_nodeLinks[i] = new vector<Node*>[numColumns];
+		int tileX = nodeIndex % m_numXTiles;
+		int tileY = nodeIndex / m_numXTiles;
+
+		if(jumpPointSearch != NULL)
+			jumpPointSearch->UpdateJumpTable(tileX, tileY, radius);
+
+		if(clusterGraph != NULL)
+			clusterGraph->UpdateArea(tileX - radius, tileY - radius, tileX + radius, tileY + radius);
 	}
 
-	// Reset stream pointer
-	inFile.seekg(0);
+	// Enemies don't change the landmark tables, but keeping them up to date stops the changes falling out of the log
+	Landmarks *landmarks = m_landmarks.load();
 
-	// Reads from the file based on how many rows of data there are and for each row read the numbers one at a time and
-	// load the data into the node for that point in the map
-	while(rowNum != numRows)
-	{
-		std::getline(inFile, inData);
-		std::stringstream tempStream(inData);
+	if(landmarks != NULL)
+		landmarks->Update();
+}
 
-		while (!tempStream.eof())
-		{
-			tempStream >> tempInt;
-			m_mapNodes[rowNum][colNum].CreateNode(counter, tempInt, colNum * m_tileWidth + m_tileWidth * 0.5, rowNum * m_tileHeight + m_tileHeight * 0.5, m_numXTiles);
+// Generates a path using the map's own search context. Only one caller may use this at a time
+Path* Map::GetPath(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner)
+{
+	// Chunks can only be unloaded while no other search is reading them, so they are left until the path queue's
+	// workers are between slices
+	TrimChunks();
 
-			colNum++;
-			counter++;
-		}
+	return GetPath(m_searchContext, _startPos, _endPos, _algoType, _isPlayer, _openListType, _planner);
+}
 
-		colNum = 0;
-		rowNum++;
-	}
+// Generates a path using the provided search context. All of the data written during the search is kept in
+// the context, so any number of searches can run on the map at the same time as long as each uses its own
+// context and the map is not changed while they run. D* Lite paths are repaired from the search state kept
+// on the given planner, and fall back to A Star if no planner is given
+Path* Map::GetPath(SearchContext &_context, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner)
+{
+	Path *newPath = new Path(_isPlayer);
+
+	FillPath(_context, newPath, _startPos, _endPos, _algoType, _isPlayer, _openListType, _planner);
+
+	// Returns a pointer to the path object generated
+	return newPath;
 }
 
-// Renders the map to the screen along with the grid and tile values if necessary
-void Map::DrawMap()
+// Generates one path for each request, with the searches spread across a pool of worker threads. Each worker
+// searches with its own context and the path objects are all created here first, so the only thing shared
+// between the searches is the map, which must not change until this returns. D* Lite requests have no
+// planner to repair so they are run as A Star. The pool is started on the first call and kept for the next
+vector<Path*> Map::GetPaths(const vector<PathRequest> &_requests, int _openListType)
 {
-	for (int y = 0; y < m_numYTiles; y++)
+	vector<Path*> paths;
+
+	TrimChunks();
+
+	for(const PathRequest &request : _requests)
+		paths.push_back(new Path(request.isPlayer));
+
+	if(m_threadPool == NULL)
 	{
-		for(int x = 0; x < m_numXTiles; x++)
-		{
-			al_draw_scaled_bitmap(m_baseTiles, 75 * m_mapNodes[y][x].GetTileType(), 0, 75, 75, x * m_tileWidth, y * m_tileHeight, m_tileWidth, m_tileHeight, 0);
+		m_threadPool = new ThreadPool(max((int)thread::hardware_concurrency(), 1));
 
-			if(m_showTileVals)
-				al_draw_textf(m_font, al_map_rgb(0,0,255), x * m_tileWidth + m_tileWidth * 0.3, y * m_tileHeight + m_tileHeight * 0.3, 0, "%f", m_mapNodes[y][x].GetTileCost());
-		}		
+		for(int i = 0; i < m_threadPool->GetNumWorkers(); i++)
+			m_workerContexts.push_back(unique_ptr<SearchContext>(new SearchContext()));
 	}
 
-	// Draws a grid over the top of the map if it is active
-	if(m_showGrid)
+	m_threadPool->Run(_requests.size(), [&](int _requestIndex, int _workerIndex)
 	{
-		for (int y = 0; y < m_numYTiles; y++)
-		{
-			for (int x = 0; x < m_numXTiles; x++)
-			{
-				al_draw_line(x * m_tileWidth, 0, x * m_tileWidth, m_numYTiles * m_tileHeight, al_map_rgb(0,0,0), 1); 
-			}
+		const PathRequest &request = _requests[_requestIndex];
 
-			al_draw_line(0, y * m_tileHeight, m_numXTiles * m_tileWidth, y * m_tileHeight, al_map_rgb(0,0,0), 1); 
-		}
-	}
+		FillPath(*m_workerContexts[_workerIndex], paths[_requestIndex], request.startPos, request.endPos, request.algoType, request.isPlayer, _openListType, NULL);
+	});
+
+	return paths;
 }
 
-void Map::ToggleGrid() { m_showGrid = !m_showGrid; }
-void Map::ToggleTileVals() { m_showTileVals = !m_showTileVals; }
-void Map::ToggleDiags() { m_allowDiags = !m_allowDiags; }
+// Queues a search for a path on the map's background workers and returns the ticket to collect the path with,
+// so the caller never waits for the search. The workers are started on the first request and kept for the next.
+// D* Lite requests repair the search state on the given planner, and requests sharing a planner are run one
+// after another
+int Map::RequestPathAsync(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, DStarLite *_planner)
+{
+	// One core is left for the thread changing the map
+	if(m_pathQueue == NULL)
+		m_pathQueue = new PathQueue(this, max((int)thread::hardware_concurrency() - 1, 1));
 
+	return m_pathQueue->Submit(_startPos, _endPos, _algoType, _isPlayer, _planner);
+}
 
-// Adds an enemy to the node given and updates each neighbouring node to say it is adjacent
-// to an enemy
-void Map::AddEnemyToNode(glm::vec2 _pos)
+// Returns the path for a ticket from RequestPathAsync once its search has finished, or NULL if it hasn't yet. The
+// caller is responsible for deleting the path
+Path* Map::CollectPath(int _ticket)
 {
-	int tempX = _pos.x/m_tileWidth;
-	int tempY = _pos.y/m_tileHeight;
-	
-	m_mapNodes[tempY][tempX].AddEnemy();
+	if(m_pathQueue == NULL)
+		return NULL;
 
-	for(Node* node : m_nodeLinks[tempY][tempX])
-	{
-		node->ToggleEnemyAdjacent();
-	}
+	return m_pathQueue->Collect(_ticket);
 }
 
-// Removes an enemy from the node given and if there are no more enemies on that node
-// then the neighbouring nodes are updated to say it is no longer adjacent to an enemy
-void Map::RemoveEnemyFromNode(glm::vec2 _pos)
+// Throws away the request for a ticket from RequestPathAsync without waiting for its search
+void Map::CancelPath(int _ticket)
+{
+	if(m_pathQueue != NULL)
+		m_pathQueue->Cancel(_ticket);
+}
+
+// Cancels the requests using the given planner and waits for the workers to stop using it, so it can be deleted
+void Map::ReleasePlanner(DStarLite *_planner)
+{
+	if(m_pathQueue != NULL)
+		m_pathQueue->ReleasePlanner(_planner);
+}
+
+// Starts telling the path when a tile it crosses changes. Must be called from the thread that changes the map,
+// and the path must be unwatched before it is deleted
+void Map::WatchPath(Path *_path)
+{
+	m_pathWatcher->Watch(_path);
+}
+
+// Stops telling the path about changes
+void Map::UnwatchPath(Path *_path)
 {
-	int tempX = _pos.x/m_tileWidth;
-	int tempY = _pos.y/m_tileHeight;
+	m_pathWatcher->Unwatch(_path);
+}
+
+// Returns the map's distance field towards the tile at the given position for the given type of entity,
+// brought up to date with the map. There is one field for each type of entity, shared by everything heading
+// for the same target, so it is only moved and repaired by the first caller after the target or map changes.
+// The field is created the first time it is requested and must only be used from the thread that changes the map
+DistanceField* Map::GetDistanceField(glm::vec2 _targetPos, bool _isPlayer)
+{
+	DistanceField *&field = m_distanceFields[_isPlayer ? 1 : 0];
+
+	if(field == NULL)
+		field = new DistanceField(this, _isPlayer);
+
+	field->Update(_targetPos);
+
+	return field;
+}
+
+// Picks a tile at random from every tile that can be reached from the given position, has its centre within the
+// radius of the centre point and is further than the minimum distance from the position. Each tile is equally
+// likely. Random tiles in the square around the circle are tried first, and if none of them are suitable every
+// tile in the square is checked and one of the suitable ones picked. Reachability is read from the connected
+// component labels, so no search is needed. Returns false if there is no suitable tile
+bool Map::GetRandomReachablePoint(glm::vec2 _fromPos, glm::vec2 _centre, float _radius, float _minDistance, glm::vec2 &_point)
+{
+	int fromIndex = GetNodeIndex(_fromPos);
+
+	int minX = max((int)((_centre.x - _radius) / m_tileWidth), 0);
+	int maxX = min((int)((_centre.x + _radius) / m_tileWidth), m_numXTiles - 1);
+	int minY = max((int)((_centre.y - _radius) / m_tileHeight), 0);
+	int maxY = min((int)((_centre.y + _radius) / m_tileHeight), m_numYTiles - 1);
+
+	if(minX > maxX || minY > maxY)
+		return false;
+
+	for(int i = 0; i < c_maxTileSamples; i++)
+	{
+		int tileX = minX + rand() % (maxX - minX + 1);
+		int tileY = minY + rand() % (maxY - minY + 1);
+
+		if(IsGoodTarget(tileX, tileY, fromIndex, _fromPos, _centre, _radius, _minDistance))
+		{
+			_point = GetNode(tileY * m_numXTiles + tileX).GetPos();
+			return true;
+		}
+	}
 
-	bool temp = m_mapNodes[tempY][tempX].RemoveEnemy();
+	vector<int> goodTiles;
 
-	if(!temp)
+	for(int y = minY; y <= maxY; y++)
 	{
-		for(Node* node : m_nodeLinks[tempY][tempX])
+		for(int x = minX; x <= maxX; x++)
 		{
-			node->ToggleEnemyAdjacent();
+			if(IsGoodTarget(x, y, fromIndex, _fromPos, _centre, _radius, _minDistance))
+				goodTiles.push_back(y * m_numXTiles + x);
 		}
 	}
+
+	if(goodTiles.empty())
+		return false;
+
+	_point = GetNode(goodTiles[rand() % goodTiles.size()]).GetPos();
+
+	return true;
 }
 
-// Generates a path and allocates it to the provided path pointer
-Path* Map::GetPath(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer)
+// Returns whether the tile is one GetRandomReachablePoint can pick
+bool Map::IsGoodTarget(int _tileX, int _tileY, int _fromIndex, glm::vec2 _fromPos, glm::vec2 _centre, float _radius, float _minDistance)
 {
-	Path *newPath;
-	newPath = new Path(_isPlayer);
+	int nodeIndex = _tileY * m_numXTiles + _tileX;
+
+	if(nodeIndex == _fromIndex || !GetComponents()->AreConnected(_fromIndex, nodeIndex))
+		return false;
+
+	glm::vec2 pos = GetNode(nodeIndex).GetPos();
+
+	return glm::distance(pos, _centre) < _radius && glm::distance(pos, _fromPos) > _minDistance;
+}
+
+// Finds a path and writes it and the details of the search to the given path object. The tiles of the path are
+// gathered in a buffer kept on the context so that no memory is allocated once it has grown
+void Map::FillPath(SearchContext &_context, Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner)
+{
+	int startIndex, endIndex;
 	int tempNumOps = 0;
 
+	if(!BeginQuery(_context, _path, _startPos, _endPos, _algoType, _planner, startIndex, endIndex))
+		return;
+
+	// Records the time at the point that the algorithm starts generating the path
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+
+	vector<int> &pathTiles = _context.GetPathTiles();
+	pathTiles.clear();
+
+	bool cached = FindCachedPath(startIndex, endIndex, _algoType, _isPlayer, pathTiles);
+	bool pathFound = cached || SearchPath(_context, _openListType, startIndex, endIndex, _algoType, _isPlayer, _planner, tempNumOps);
+
+	FinishQuery(_context, _path, startIndex, endIndex, _algoType, _isPlayer, pathFound, cached, true, pathTiles);
+
+	// Records the time at the point the path has been generated
+	chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+
+	// Calculates the time it took to generate the path
+	long long duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+	// Updates details on the path and smooths it (removes unnecessary nodes)
+	_path->SetPathCalcTime(duration);
+	_path->SetNumOperations(tempNumOps);
+	//_path->SmoothPath(_startPos, _endPos);
+}
+
+// Checks the start and end points of a query and prepares the context to search between them. Returns false,
+// with the reason written to the path, if no search is needed. The algorithm is changed to A Star if the one
+// asked for can't be used
+bool Map::BeginQuery(SearchContext &_context, Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int &_algoType, DStarLite *_planner, int &_startIndex, int &_endIndex)
+{
+	_path->SetMapVersion(m_mapVersion);
+
 	// Create pointers to the nodes at the start position and the destination
-	Node *startPoint = &m_mapNodes[(int)(_startPos.y / m_tileHeight)][(int)(_startPos.x / m_tileWidth)];
-	Node *endPoint = &m_mapNodes[(int)(_endPos.y / m_tileHeight)][(int)(_endPos.x / m_tileWidth)];
-	bool pathNeeded = true;
+	Node *startPoint = &GetNode(GetNodeIndex(_startPos));
+	Node *endPoint = &GetNode(GetNodeIndex(_endPos));
 
 	// Initial simple checks to make sure the start and end points are valid
 	if(startPoint->GetNodeIndex() == endPoint->GetNodeIndex())
 	{
-		newPath->SetPathMessage("You are already at your destination!");
-		return newPath;
+		_path->SetStatus(PATH_AT_DESTINATION);
+		return false;
 	}
 
 	if(!startPoint->IsTraversable())
 	{
-		newPath->SetPathMessage("Invalid start point - please choose another!");
-		return newPath;
+		_path->SetStatus(PATH_INVALID_START);
+		return false;
 	}
 
 	if(!endPoint->IsTraversable())
 	{
-		newPath->SetPathMessage("Invalid end point - please choose another!");
-		return newPath;
+		_path->SetStatus(PATH_INVALID_END);
+		return false;
 	}
-	
-	Node *parentNode;
-	parentNode = startPoint;
 
-	Node *childNode;
+	_startIndex = startPoint->GetNodeIndex();
+	_endIndex = endPoint->GetNodeIndex();
 
-	// Cleans up all nodes on the map to ensure all costs have been reset
-	PathCleanup();
+	// Tiles in different connected components have no path between them, so there is no need to search. The
+	// components aren't built just for this check, so until something else needs them every query searches
+	ConnectedComponents *components = m_components.load(memory_order_acquire);
 
-	// Records the time at the point that the algorithm starts generating the path
-	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	if(components != NULL && !components->AreConnected(_startIndex, _endIndex))
+	{
+		_path->SetStatus(PATH_UNREACHABLE);
+		return false;
+	}
 
-	// Adds parent(start position) node to the open node list and updates its cost
-	m_openNodeList.push_back(parentNode);
-	m_openNodeList.front()->UpdateFCost(DistBetweenNodes(*m_openNodeList.front(), *endPoint));
+	// Starts a new search generation on the context so that every node is treated as unvisited
+	_context.BeginSearch(m_numXTiles * m_numYTiles);
+	_context.SetBucketWidth(m_bucketWidth);
 
-	bool pathFound = false;
+	// Jump point search relies on diagonal moves to skip over open areas, so without them A Star is used
+	if((_algoType == ALGO_JUMP_POINT || _algoType == ALGO_JUMP_POINT_PLUS) && !m_allowDiags)
+		_algoType = ALGO_A_STAR;
 
-	while(pathFound == false)
-	{
-		float lowestCost = 100000000.0f;
-		float tempCost = 0;
-		int indexCounter = 0;
-		int loopCounter = 0;
-		int loopSize = 0;
+	if(_algoType == ALGO_D_STAR_LITE && _planner == NULL)
+		_algoType = ALGO_A_STAR;
 
-		// Counts how many nodes are on the open node list and loops over it to find the one with the cheapest F or G cost
-		// depending on what type of algorithm is being used
-		loopSize = m_openNodeList.size();
+	return true;
+}
 
-		while(loopCounter < loopSize)
-		{
-			if(_algoType == 0)
-				tempCost = m_openNodeList[loopCounter]->GetFCost();
+// Looks for the same query in the path cache and copies its tiles if it is there. D* Lite paths depend on the
+// state of the planner so are never cached
+bool Map::FindCachedPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, vector<int> &_tiles)
+{
+	return _algoType != ALGO_D_STAR_LITE && m_pathCache->FindPath(_startIndex, _endIndex, _algoType, _isPlayer, m_forgottenVersion, _tiles);
+}
 
-			else if(_algoType == 1)
-				tempCost = m_openNodeList[loopCounter]->GetGCost();
+// Runs the whole search for the given algorithm. Returns whether the end node was reached
+bool Map::SearchPath(SearchContext &_context, int _openListType, int _startIndex, int _endIndex, int _algoType, bool _isPlayer, DStarLite *_planner, int &_numOps)
+{
+	OpenList *openList = _context.GetOpenList(_openListType);
 
-			if(tempCost < lowestCost)
-			{
-				lowestCost = tempCost;
-				indexCounter = loopCounter;
-			}
+	if(_algoType == ALGO_JUMP_POINT || _algoType == ALGO_JUMP_POINT_PLUS)
+		return GetJumpPointSearch()->FindPath(_context, openList, _startIndex, _endIndex, _isPlayer, _algoType == ALGO_JUMP_POINT_PLUS, _numOps);
+	else if(_algoType == ALGO_HIERARCHICAL)
+		return GetClusterGraph()->FindPath(_context, _startIndex, _endIndex, _isPlayer, _numOps);
+	else if(_algoType == ALGO_D_STAR_LITE)
+		return _planner->FindPath(_context, _startIndex, _endIndex, _numOps);
+	else if(_algoType == ALGO_BIDIRECTIONAL_A_STAR || _algoType == ALGO_BIDIRECTIONAL_DIJKSTRA)
+		return m_bidirectionalSearch->FindPath(_context, _openListType, _startIndex, _endIndex, _isPlayer, _algoType == ALGO_BIDIRECTIONAL_A_STAR, _numOps);
 
-			loopCounter++;
-		}
+	StartBestFirstSearch(_context, openList, _startIndex, _endIndex, _algoType);
 
-		childNode = m_openNodeList[indexCounter];
-		
-		// Adds a pointer to the lowest cost node into the closed list
-		m_closedNodeList.push_back(childNode);
-		m_openNodeList.erase(m_openNodeList.begin() + indexCounter);
+	return ContinueBestFirstSearch(_context, openList, _endIndex, _algoType, _isPlayer, numeric_limits<int>::max(), _numOps) == SEARCH_FOUND;
+}
 
-		tempNumOps++;
+// Writes the tiles of a finished search to the path along with the name of the algorithm. Paths the search
+// found are added to the cache if they can be, which isn't the case for a search that ran while the map changed
+void Map::FinishQuery(SearchContext &_context, Path *_path, int _startIndex, int _endIndex, int _algoType, bool _isPlayer, bool _pathFound, bool _cached, bool _cacheable, vector<int> &_tiles)
+{
+	// If the open list emptied without reaching the destination no path could be found
+	// The status of the path is updated and the function returns to the caller
+	if(!_pathFound)
+	{
+		_path->SetStatus(PATH_NOT_FOUND);
+		return;
+	}
 
-		// Checks if the last node added to the closed list is the goal and if it is continues out of the while loop
-		if(m_closedNodeList.back()->GetNodeIndex() == endPoint->GetNodeIndex())
-		{
-			pathFound = true;
-			continue;
-		}
+	// Each node from the destination back to the start is added to the path by following the parents stored
+	// on the context. This continues until the start node, which has no parent, is added. Jump point search
+	// stores jump points as parents, so the nodes between each pair are added as well. The path is then cached
+	// until a tile on or next to it changes
+	if(!_cached)
+	{
+		int pathIndex = _endIndex;
 
-		int tempX = childNode->GetTileX();
-		int tempY = childNode->GetTileY();
+		while(pathIndex != -1)
+		{
+			int parentIndex = _context.GetParent(pathIndex);
 
-		bool onClosedList = false;
-		bool onOpenList = false;
+			_tiles.push_back(pathIndex);
 
-		// Checks each neighbour of the last node added to the closed list against the closed and open lists.
-		for(Node *neighbour : m_nodeLinks[tempY][tempX])
-		{
-			onClosedList = false;
-			onOpenList = false;
-			
-			// For A* algorithm
-			if(_algoType == 0)
+			if(parentIndex != -1)
 			{
-				// Checks the current neighbour against the closed list and if it's on there this neighbour is skipped
-				for(Node* closedNode : m_closedNodeList)
-				{
-						if(neighbour->GetNodeIndex() == closedNode->GetNodeIndex())
-						{
-							onClosedList = true;
-							continue;
-						}
-				}
-
-				if(onClosedList == false)
-				{
-					// Checks the current neighbour against the open node list. If it's on there the G cost on the node is compared to the G cost of
-					// the path to get there using the current path. If the current path G cost is smaller the G and F costs on the neighbour are
-					// updated and the parent is changed to the current node. Otherwise the neighbour is skipped
-					for(Node* openNode : m_openNodeList)
-					{
-							if(neighbour->GetNodeIndex() == openNode->GetNodeIndex())
-							{
-								onOpenList = true;
-							
-								if(neighbour->GetGCost() > (glm::distance(neighbour->GetPos(), childNode->GetPos()) * neighbour->GetTileCost()) + childNode->GetGCost())
-								{
-									openNode->UpdateGCost(glm::distance(neighbour->GetPos(), childNode->GetPos()), childNode->GetTileCost(), childNode->GetGCost(), _isPlayer); 
-									openNode->UpdateFCost(DistBetweenNodes(*openNode, *endPoint));
-									openNode->UpdateParent(childNode);
-								}
-
-								continue;
-							}
-					}			
-
-					// If the current neighbour is not on either list it is added to the open list and the costs and parent are updated
-					if(onOpenList == false)
-					{
-						neighbour->UpdateGCost(glm::distance(neighbour->GetPos(), childNode->GetPos()), childNode->GetTileCost(), childNode->GetGCost(), _isPlayer);
-						neighbour->UpdateFCost(DistBetweenNodes(*neighbour, *endPoint));
-						neighbour->UpdateParent(childNode);
-						m_openNodeList.push_back(neighbour);
-					}
-				}
-			}
+				int stepX = GetNode(parentIndex).GetTileX() - GetNode(pathIndex).GetTileX();
+				int stepY = GetNode(parentIndex).GetTileY() - GetNode(pathIndex).GetTileY();
+				int step = (stepY > 0) - (stepY < 0);
+				step = step * m_numXTiles + (stepX > 0) - (stepX < 0);
 
-			// For Dijkstra's algorithm
-			if(_algoType == 1)
-			{
-				for(Node* closedNode : m_closedNodeList)
-				{
-					// Checks the current neighbour against the closed list and if it's on there this neighbour is skipped
-					if(neighbour->GetNodeIndex() == closedNode->GetNodeIndex())
-					{
-						if(neighbour->GetGCost() > (glm::distance(neighbour->GetPos(), childNode->GetPos()) * neighbour->GetTileCost()) + childNode->GetGCost())
-						{
-							closedNode->UpdateGCost(glm::distance(neighbour->GetPos(), childNode->GetPos()), childNode->GetTileCost(), childNode->GetGCost(), _isPlayer);
-							closedNode->UpdateParent(childNode);
-						}
-
-						onClosedList = true;
-						continue;
-					}
-				}
-
-				if(onClosedList == false)
-				{
-					// Checks the current neighbour against the open node list. If it's on there the G cost on the node is compared to the G cost of
-					// the path to get there using the current path. If the current path G cost is smaller the G and F costs on the neighbour are
-					// updated and the parent is changed to the current node. Otherwise the neighbour is skipped
-					for(Node* openNode : m_openNodeList)
-					{
-							if(neighbour->GetNodeIndex() == openNode->GetNodeIndex())
-							{
-								onOpenList = true;
-							
-								if(neighbour->GetGCost() > (glm::distance(neighbour->GetPos(), childNode->GetPos()) * neighbour->GetTileCost()) + childNode->GetGCost())
-								{
-									openNode->UpdateGCost(glm::distance(neighbour->GetPos(), childNode->GetPos()), childNode->GetTileCost(), childNode->GetGCost(), _isPlayer); 
-									openNode->UpdateParent(childNode);
-								}
-
-								continue;
-							}
-					}			
-
-					// If the current neighbour is not on either list it is added to the open list and the costs and parent are updated
-					if(onOpenList == false)
-					{
-						neighbour->UpdateGCost(glm::distance(neighbour->GetPos(), childNode->GetPos()), childNode->GetTileCost(), childNode->GetGCost(), _isPlayer);
-						neighbour->UpdateParent(childNode);
-						m_openNodeList.push_back(neighbour);
-					}
-				}
+				for(int n = pathIndex + step; n != parentIndex; n += step)
+					_tiles.push_back(n);
 			}
-	
+
+			pathIndex = parentIndex;
 		}
 
-		parentNode = childNode;
+		if(_algoType != ALGO_D_STAR_LITE && _cacheable)
+			m_pathCache->AddPath(_startIndex, _endIndex, _algoType, _isPlayer, m_mapVersion, _tiles);
+	}
 
-		// If the open list is empty at this point it means no path could be found to the destination
-		// The message on the path is updated and the function returns to the caller
-		if(m_openNodeList.empty())
-		{
-			newPath->SetPathMessage("No path found (probably caused by broken code...)");
+	for(int tile : _tiles)
+		_path->AddNodeToBack(GetNode(tile));
 
-			parentNode = nullptr;
-			childNode = nullptr;
+	// Updates the details on the path object
+	_path->SetAlgoType(_algoType);
+	_path->SetStatus(PATH_FOUND);
+}
 
-			return newPath;
-		}
-	}
+// Adds the start node to the open list and updates its cost, ready for A Star or Dijkstra's algorithm to be run
+// from it. A Star orders the open list by F cost and Dijkstra's algorithm orders it by G cost, which is what its
+// F cost is left as
+void Map::StartBestFirstSearch(SearchContext &_context, OpenList *_openList, int _startIndex, int _endIndex, int _algoType)
+{
+	float startFCost = _algoType == ALGO_DIJKSTRA ? 0.0f : Heuristic(_startIndex, _endIndex);
 
-	// The child node is pointed at the back of the closed list and each time the pointed to node is added
-	// to the path object and the child pointer is updated to point at the parent. This continues until the
-	// child node points at nullptr, at which point the loop ends
-	childNode = m_closedNodeList.back();
+	_context.SetSearchState(_startIndex, NODE_OPEN);
+	_context.SetCosts(_startIndex, 0.0f, startFCost);
+	_context.SetParent(_startIndex, -1);
+	_openList->Push(_startIndex, startFCost);
+}
+
+// Runs A Star or Dijkstra's algorithm until the end node is closed, the open list runs out or the given number of
+// nodes have been expanded, in which case calling this again carries on from where it stopped. Once the end node
+// is reached the parents on the context lead from it back to the start. The algorithm, whether diagonal moves are
+// allowed and the type of entity are all fixed for the query, so they are only checked here to pick the version
+// of the search compiled for them
+int Map::ContinueBestFirstSearch(SearchContext &_context, OpenList *_openList, int _endIndex, int _algoType, bool _isPlayer, int _maxExpansions, int &_numOps)
+{
+	bool dijkstra = _algoType == ALGO_DIJKSTRA;
 
-	while(childNode != nullptr)
+	if(m_allowDiags)
 	{
-		newPath->AddNodeToBack(childNode);
-		childNode = childNode->GetParent();
+		if(_isPlayer)
+			return dijkstra ? SearchKernel<DijkstraPolicy, EightConnected, PlayerCost>(_context, _openList, _endIndex, _maxExpansions, _numOps)
+							: SearchKernel<AStarPolicy, EightConnected, PlayerCost>(_context, _openList, _endIndex, _maxExpansions, _numOps);
+
+		return dijkstra ? SearchKernel<DijkstraPolicy, EightConnected, EnemyCost>(_context, _openList, _endIndex, _maxExpansions, _numOps)
+						: SearchKernel<AStarPolicy, EightConnected, EnemyCost>(_context, _openList, _endIndex, _maxExpansions, _numOps);
 	}
 
-	// Records the time at the point the path has been generated
-	chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+	if(_isPlayer)
+		return dijkstra ? SearchKernel<DijkstraPolicy, FourConnected, PlayerCost>(_context, _openList, _endIndex, _maxExpansions, _numOps)
+						: SearchKernel<AStarPolicy, FourConnected, PlayerCost>(_context, _openList, _endIndex, _maxExpansions, _numOps);
 
-	// Updates the details on the path object
-	switch(_algoType)
+	return dijkstra ? SearchKernel<DijkstraPolicy, FourConnected, EnemyCost>(_context, _openList, _endIndex, _maxExpansions, _numOps)
+					: SearchKernel<AStarPolicy, FourConnected, EnemyCost>(_context, _openList, _endIndex, _maxExpansions, _numOps);
+}
+
+// The best first search loop for one combination of algorithm, connectivity and type of entity
+template<class Algorithm, class Connectivity, class CostModel>
+int Map::SearchKernel(SearchContext &_context, OpenList *_openList, int _endIndex, int _maxExpansions, int &_numOps)
+{
+	Node *childNode;
+
+	for(int expansions = 0; expansions < _maxExpansions; expansions++)
 	{
-		case 0:
-			{
-				newPath->SetPathMessage("A Star");
-				newPath->SetAlgoType(0);
-			}
-			break;
-		case 1:
+		if(_openList->IsEmpty())
+			return SEARCH_FAILED;
+
+		// Takes the node with the cheapest F or G cost off the open list and marks it as closed
+		int lowestIndex = _openList->PopLowest();
+		childNode = &GetNode(lowestIndex);
+
+		_context.SetSearchState(lowestIndex, NODE_CLOSED);
+
+		_numOps++;
+
+		// Checks if the node just closed is the goal and if it is the search is finished
+		if(lowestIndex == _endIndex)
+			return SEARCH_FOUND;
+
+		unsigned char neighbourMask = m_neighbourMasks[lowestIndex];
+		float childGCost = _context.GetGCost(lowestIndex);
+
+		// Checks the search state of each neighbour of the node just closed
+		for(int i = 0; i < Connectivity::c_numDirections; i++)
+		{
+			int dir = Connectivity::GetDirection(i);
+
+			if(!(neighbourMask & (1 << dir)))
+				continue;
+
+			int neighbourIndex = lowestIndex + m_dirOffsets[dir];
+			Node *neighbour = &GetNode(neighbourIndex);
+			int neighbourState = _context.GetSearchState(neighbourIndex);
+
+			// If the neighbour is closed it is skipped. Nodes are taken off the open list in cost
+			// order so a closed node already has its cheapest cost
+			if(neighbourState == NODE_CLOSED)
+				continue;
+
+			float tempGCost = CostModel::CalcGCost(*neighbour, neighbourIndex, m_occupancy, m_dirLengths[dir], childNode->GetTileCost(), childGCost);
+
+			// If the neighbour is already on the open list its G cost is compared to the G cost of the path to
+			// get there using the current path. If the current path is cheaper the neighbour is skipped
+			if(neighbourState == NODE_OPEN && tempGCost >= _context.GetGCost(neighbourIndex))
+				continue;
+
+			// Otherwise the costs and parent of the neighbour are updated and it is either moved up the
+			// open list or added to it if this search has not visited it yet
+			float tempFCost = Algorithm::c_useHeuristic ? tempGCost + Heuristic(neighbourIndex, _endIndex) : tempGCost;
+
+			_context.SetCosts(neighbourIndex, tempGCost, tempFCost);
+			_context.SetParent(neighbourIndex, lowestIndex);
+
+			if(neighbourState == NODE_OPEN)
+				_openList->DecreaseKey(neighbourIndex, tempFCost);
+
+			else
 			{
-				newPath->SetPathMessage("Dijkstra");
-				newPath->SetAlgoType(1);
+				_context.SetSearchState(neighbourIndex, NODE_OPEN);
+				_openList->Push(neighbourIndex, tempFCost);
 			}
-			break;
+		}
 	}
 
-	// Calculates the time it took to generate the path
-	int duration = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+	// Stopped after expanding as many nodes as it was allowed to
+	return SEARCH_RUNNING;
+}
 
-	// Updates details on the path and smooths it (removes unnecessary nodes)
-	newPath->SetPathCalcTime(duration);
-	newPath->SetNumOperations(tempNumOps);
-	//newPath->SmoothPath(_startPos, _endPos);
+// Returns the cost of moving from one node to a neighbouring node for the given type of entity. The length of
+// the move is the same one the best first search uses, so every algorithm agrees on the cost of a path
+float Map::GetMoveCost(int _fromIndex, int _toIndex, bool _isPlayer)
+{
+	Node &from = GetNode(_fromIndex);
+	Node &to = GetNode(_toIndex);
 
-	parentNode = nullptr;
-	childNode = nullptr;
+	// Directions are ordered by row and then column around the node, skipping the node itself
+	int dir = (to.GetTileY() - from.GetTileY() + 1) * 3 + (to.GetTileX() - from.GetTileX() + 1);
 
-	// Returns a pointer to the path object generated
-	return newPath;
+	if(dir > DIR_WEST)
+		dir--;
+
+	return to.CalcGCost(m_dirLengths[dir], from.GetTileCost(), 0.0f, _isPlayer, m_occupancy->GetCostScale(_toIndex));
+}
+
+// Returns the A Star estimate of the cost from the node to the end. Neither heuristic overestimates, so A Star
+// finds the cheapest path with either. When landmarks are turned off the distance between the nodes is scaled by
+// the cost per distance of the cheapest terrain, as moving along a road costs less than the distance
+float Map::Heuristic(int _nodeIndex, int _endIndex)
+{
+	if(m_useLandmarks)
+		return GetLandmarks()->Heuristic(_nodeIndex, _endIndex);
+
+	return DistBetweenNodes(GetNode(_nodeIndex), GetNode(_endIndex)) * c_minCostPerDistance;
 }
 
 // Calculates and returns the distance between the two nodes provided. This distance is
@@ -530,115 +876,184 @@ float Map::DistBetweenNodes(Node &_first, Node &_second)
 	return distance;
 }
 
-// Cycles through all of the nodes in the map and updates the list of edges
-// for each node used by the pathfinding algorithm
+// Brings the neighbour masks and everything built from them up to date. Changes to tiles and to whether diagonal
+// moves are allowed already update the parts they affect, so the masks are only built from scratch after a map
+// has been loaded, and otherwise nothing needs doing
 void Map::UpdateEdgeList()
 {
-	// Loop over the nodeLinks vector and clear each list
-	// Each node has its own vector of pointers to adjoining nodes
-	// The X and Y values refer to the X and Y of the node in question
-	for(int y = 0; y < m_numYTiles; y++)
+	unique_lock<shared_timed_mutex> lock = LockForEdit();
+
+	if(m_edgesDirty)
 	{
-		for(int x = 0; x < m_numXTiles; x++)
+		for(int y = 0; y < m_numYTiles; y++)
 		{
-			UpdateSingleNodeEdgeList(x, y);
+			for(int x = 0; x < m_numXTiles; x++)
+			{
+				UpdateSingleNodeEdgeList(x, y);
+			}
 		}
+
+		m_edgesDirty = false;
 	}
+
+	UpdateDiagDependents();
+}
+
+// Rebuilds the data that depends on whether diagonal moves are allowed, if it was built with the other setting.
+// The cached costs inside each cluster depend on it, and so do the connected components
+void Map::UpdateDiagDependents()
+{
+	ClusterGraph *clusterGraph = m_clusterGraph.load();
+	ConnectedComponents *components = m_components.load();
+
+	if(clusterGraph != NULL && clusterGraph->BuiltWithDiags() != m_allowDiags)
+		clusterGraph->RebuildGraph();
+
+	// Without diagonal moves tiles that only touch at a corner are no longer connected
+	if(components != NULL && components->BuiltWithDiags() != m_allowDiags)
+		components->RebuildLabels();
 }
 
-// Updates the edge links for the nodes at the input X and Y coordinates
+// Updates the neighbour mask for the node at the input X and Y coordinates. A direction is set in the mask
+// if the neighbour in that direction is on the map and traversable
 void Map::UpdateSingleNodeEdgeList(int _nodeX, int _nodeY)
 {
-	m_nodeLinks[_nodeY][_nodeX].clear();
-	
-	// If the node is not on the top row...
-	if(_nodeY > 0)
+	m_neighbourMasks[_nodeY * m_numXTiles + _nodeX] = CalcNeighbourMask(_nodeX, _nodeY);
+}
+
+// Sets or clears the bit linking each neighbouring node to the given node, depending on whether it is traversable
+void Map::UpdateLinksTo(int _nodeIndex)
+{
+	int nodeX = _nodeIndex % m_numXTiles;
+	int nodeY = _nodeIndex / m_numXTiles;
+	bool traversable = GetNode(_nodeIndex).IsTraversable();
+
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
 	{
-		// ...and diagonal movement is allowed add pointers to the three nodes above it
-		if(m_allowDiags)
-		{
-			for(int n = _nodeX-1; n <= _nodeX+1; n++)
-			{
-				if(n >= 0 && n < m_numXTiles)
-				{
-					if(m_mapNodes[_nodeY-1][n].IsTraversable())
-						m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY-1][n]);
-				}
+		int x = nodeX + c_dirX[dir];
+		int y = nodeY + c_dirY[dir];
 
-			}
-		}
+		if(x < 0 || x >= m_numXTiles || y < 0 || y >= m_numYTiles)
+			continue;
 
-		// ...otherwise add a pointer to the node directly above it
-		else
-		{
-			if(m_mapNodes[_nodeY-1][_nodeX].IsTraversable())
-						m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY-1][_nodeX]);
-		}
+		unsigned char &mask = m_neighbourMasks[_nodeIndex + m_dirOffsets[dir]];
+		unsigned char link = 1 << OppositeDirection(dir);
+
+		mask = traversable ? mask | link : mask & ~link;
 	}
+}
+
+// Builds the neighbour mask for the node at the input X and Y coordinates from the neighbours in all eight directions.
+// Whether a neighbour is traversable is read without loading its chunk where possible
+unsigned char Map::CalcNeighbourMask(int _nodeX, int _nodeY)
+{
+	unsigned char mask = 0;
 
-	// If the node is not in the left-most column add a pointer to the node to the left
-	if(_nodeX > 0)
+	for(int dir = 0; dir < NUM_DIRECTIONS; dir++)
 	{
-		if(m_mapNodes[_nodeY][_nodeX-1].IsTraversable())
-			m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY][_nodeX-1]);
+		int x = _nodeX + c_dirX[dir];
+		int y = _nodeY + c_dirY[dir];
+
+		if(x >= 0 && x < m_numXTiles && y >= 0 && y < m_numYTiles && m_mapNodes->IsTraversable(y * m_numXTiles + x))
+			mask |= 1 << dir;
 	}
 
-	// If the node is not in the left-most column add a pointer to the node to the right
-	if(_nodeX < m_numXTiles - 1)
+	return mask;
+}
+
+// Records a change to the given node in the change log at the current map version. When the log is full the
+// oldest change is overwritten and its version is remembered as forgotten. The cached paths and the paths being
+// followed that cross the node are invalidated, apart from the enemies' paths for changes that only affect the
+// player's costs
+void Map::LogChange(int _nodeIndex, bool _playerCostsOnly)
+{
+	MapChange &change = m_changeLog[m_changeLogHead];
+
+	m_forgottenVersion = max(m_forgottenVersion, change.version);
+
+	change.version = m_mapVersion;
+	change.nodeIndex = _nodeIndex;
+
+	m_pathCache->InvalidateTile(_nodeIndex, _playerCostsOnly);
+	m_pathWatcher->TileChanged(_nodeIndex, _playerCostsOnly);
+
+	m_changeLogHead = (m_changeLogHead + 1) % c_changeLogSize;
+}
+
+// Locks the map so it can be changed, waiting for the background searches to finish the slice they are on.
+// Searches waiting to start their next slice hold off until the change is made, so a change is never starved
+unique_lock<shared_timed_mutex> Map::LockForEdit()
+{
 	{
-		if(m_mapNodes[_nodeY][_nodeX+1].IsTraversable())
-			m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY][_nodeX+1]);
+		lock_guard<mutex> editsLock(m_editsMutex);
+		m_editsWaiting++;
 	}
 
-	// If the node is not in the bottom row...
-	if( _nodeY < m_numYTiles - 1)
+	unique_lock<shared_timed_mutex> lock(m_mapMutex);
+
 	{
-		// ...and diagonal movement is allowed add pointers to the three nodes below it
-		if(m_allowDiags)
-		{
-			for(int n = _nodeX-1; n <= _nodeX+1; n++)
-			{
-				if(n >= 0 && n < m_numXTiles)
-				{
-					if(m_mapNodes[_nodeY+1][n].IsTraversable())
-						m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY+1][n]);
-				}
+		lock_guard<mutex> editsLock(m_editsMutex);
+		m_editsWaiting--;
+	}
 
-			}
-		}
+	m_editsCondition.notify_all();
 
-		// otherwise add a pointer to the node directly below it
-		else
-		{
-			if(m_mapNodes[_nodeY+1][_nodeX].IsTraversable())
-						m_nodeLinks[_nodeY][_nodeX].push_back(&m_mapNodes[_nodeY+1][_nodeX]);
-		}
-	}					
+	return lock;
 }
 
-// Loops over all nodes that have been used by the path finding algorithm and resets them
-void Map::PathCleanup()
+// Locks the map for a background search to read it. Any number of searches can hold the lock at once. While an
+// edit is waiting the search sleeps until the editor has the map, then blocks on the map lock until it is done
+shared_lock<shared_timed_mutex> Map::LockForSearch()
 {
-	for(Node* n : m_closedNodeList)
 	{
-		n->ResetNode();
+		unique_lock<mutex> editsLock(m_editsMutex);
+		m_editsCondition.wait(editsLock, [this] { return m_editsWaiting == 0; });
 	}
 
-	for(Node* n : m_openNodeList)
+	return shared_lock<shared_timed_mutex>(m_mapMutex);
+}
+
+// Unloads chunks over the memory budget, unless a background search is reading the map
+void Map::TrimChunks()
+{
+	unique_lock<shared_timed_mutex> lock(m_mapMutex, try_to_lock);
+
+	if(lock.owns_lock())
+		m_mapNodes->TrimToBudget();
+}
+
+// Returns the table, building it the first time it is asked for. Searches running at the same time may ask at
+// once, so only the first builds it and the rest wait for it. A table is only ever deleted with the map
+template<class Table>
+Table* Map::BuildOnce(atomic<Table*> &_table)
+{
+	Table *table = _table.load(memory_order_acquire);
+
+	if(table != NULL)
+		return table;
+
+	lock_guard<mutex> lock(m_buildMutex);
+
+	table = _table.load(memory_order_relaxed);
+
+	if(table == NULL)
 	{
-		n->ResetNode();
+		table = new Table(this);
+		_table.store(table, memory_order_release);
 	}
 
-	m_openNodeList.clear();
-	m_closedNodeList.clear();
+	return table;
 }
+
+// Returns the jump point search data, building the jump tables the first time a jump point search runs
+JumpPointSearch* Map::GetJumpPointSearch() { return BuildOnce(m_jumpPointSearch); }
+
+// Returns the cluster graph, building it the first time a hierarchical search runs
+ClusterGraph* Map::GetClusterGraph() { return BuildOnce(m_clusterGraph); }
+
+// Forgets every enemy on the map and takes their costs off the tiles around them
 void Map::ResetMap()
 {
-	for(int y = 0; y < m_numYTiles; y++)
-	{
-		for(int x = 0; x < m_numXTiles; x++)
-		{
-			m_mapNodes[y][x].ClearNode();
-		}
-	}
+	m_occupancy->Clear();
+	UpdateOccupancy();
 }
\ No newline at end of file
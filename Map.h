@@ -8,62 +8,205 @@
 #include <sstream>
 #include "Node.h"
 #include "glm\glm.hpp"
-#include <allegro5\allegro_primitives.h>
-#include <allegro5\allegro_font.h>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
 #include "Path.h"
+#include "SearchContext.h"
+#include "Directions.h"
 
 using namespace std;
 
+class JumpPointSearch;
+class ClusterGraph;
+class BidirectionalSearch;
+class DistanceField;
+class Landmarks;
+class DStarLite;
+class ThreadPool;
+class PathQueue;
+class PathCache;
+class ChunkStore;
+class ConnectedComponents;
+class OccupancyMap;
+class PathWatcher;
+
+// A single query in a batch of paths requested from the map at once
+struct PathRequest
+{
+	glm::vec2 startPos;
+	glm::vec2 endPos;
+	int algoType;
+	bool isPlayer;
+};
+
+// States a search run a few expansions at a time can be left in
+enum SearchStatus
+{
+	SEARCH_RUNNING = 0,
+	SEARCH_FOUND = 1,
+	SEARCH_FAILED = 2
+};
+
+// Cheapest cost per unit of distance of any move on the map (road tiles). Scaling the distance heuristic by
+// it keeps it from ever overestimating
+const float c_minCostPerDistance = 0.5f;
+
+// Number of random tiles tried when picking a reachable tile before every tile in range is checked instead
+const int c_maxTileSamples = 16;
+
+// Number of node changes the map remembers for planners that repair their paths incrementally
+const int c_changeLogSize = 4096;
+
+// Records that the costs around a node changed at the given map version
+struct MapChange
+{
+	unsigned int version;
+	int nodeIndex;
+};
+
 class Map
 {
 	public:
 		// Constructor and destructor
-		Map(int _winWidth, int _winHeight);
+		Map(int _winWidth, int _winHeight, string _mapFile = "Base Map.txt");
 		~Map();
 
 		// Getters
 		bool DiagsAllowed();
+		bool LandmarksEnabled();
 		bool IsPointTraversable(glm::vec2 &_point);
+		unsigned int GetMapVersion();
+		unsigned int GetCostVersion(bool _isPlayer);
 		int GetNodeIndex(glm::vec2 _pos);
+		int GetNumXTiles();
+		int GetNumYTiles();
+		int GetNumNodes();
+		int GetNumLoadedChunks();
+		float GetTileWidth();
+		float GetTileHeight();
+		float GetBucketWidth();
+
+		Node& GetNode(int _nodeIndex);
+		PathCache* GetPathCache();
+		Landmarks* GetLandmarks();
+		ConnectedComponents* GetComponents();
+		OccupancyMap* GetOccupancy();
+		unsigned char GetNeighbourMask(int _nodeIndex);
+		int GetNeighbourIndex(int _nodeIndex, int _dir);
+		bool GetChangesSince(unsigned int _version, vector<int> &_changedNodes);
 		
 
 		// Setters
 		void ChangeTile(float _xPos, float _yPos, int _tileType);
 		
-		void LoadMap();
-		void DrawMap();
+		void LoadMap(string _mapFile);
 
-		void ToggleGrid();
-		void ToggleTileVals();
 		void ToggleDiags();
+		void SetLandmarksEnabled(bool _enabled);
+		void SetChunkMemoryBudget(size_t _bytes);
 
 		void AddEnemyToNode(glm::vec2 _pos);
 		void RemoveEnemyFromNode(glm::vec2 _pos);
+		void UpdateOccupancy();
 		
-		Path* GetPath(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer);
+		Path* GetPath(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType = OPEN_LIST_BINARY_HEAP, DStarLite *_planner = NULL);
+		Path* GetPath(SearchContext &_context, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType = OPEN_LIST_BINARY_HEAP, DStarLite *_planner = NULL);
+		vector<Path*> GetPaths(const vector<PathRequest> &_requests, int _openListType = OPEN_LIST_BINARY_HEAP);
+		int RequestPathAsync(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, DStarLite *_planner = NULL);
+		Path* CollectPath(int _ticket);
+		void CancelPath(int _ticket);
+		void ReleasePlanner(DStarLite *_planner);
+		void WatchPath(Path *_path);
+		void UnwatchPath(Path *_path);
+		DistanceField* GetDistanceField(glm::vec2 _targetPos, bool _isPlayer);
+		bool GetRandomReachablePoint(glm::vec2 _fromPos, glm::vec2 _centre, float _radius, float _minDistance, glm::vec2 &_point);
+		float Heuristic(int _nodeIndex, int _endIndex);
 		float DistBetweenNodes(Node &_first, Node &_second);
+		float GetMoveCost(int _fromIndex, int _toIndex, bool _isPlayer);
 		void UpdateEdgeList();
 		void UpdateSingleNodeEdgeList(int _nodeX, int _nodeY);
 
-		void PathCleanup();
 		void ResetMap();
 
+		// Locks used to keep the map from changing while background searches read it
+		unique_lock<shared_timed_mutex> LockForEdit();
+		shared_lock<shared_timed_mutex> LockForSearch();
+
+		// Steps of a path query, used by GetPath and by PathSearch to run a query a slice at a time
+		bool BeginQuery(SearchContext &_context, Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int &_algoType, DStarLite *_planner, int &_startIndex, int &_endIndex);
+		bool FindCachedPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, vector<int> &_tiles);
+		bool SearchPath(SearchContext &_context, int _openListType, int _startIndex, int _endIndex, int _algoType, bool _isPlayer, DStarLite *_planner, int &_numOps);
+		void StartBestFirstSearch(SearchContext &_context, OpenList *_openList, int _startIndex, int _endIndex, int _algoType);
+		int ContinueBestFirstSearch(SearchContext &_context, OpenList *_openList, int _endIndex, int _algoType, bool _isPlayer, int _maxExpansions, int &_numOps);
+		void FinishQuery(SearchContext &_context, Path *_path, int _startIndex, int _endIndex, int _algoType, bool _isPlayer, bool _pathFound, bool _cached, bool _cacheable, vector<int> &_tiles);
+
 	private:
+		void LogChange(int _nodeIndex, bool _playerCostsOnly = false);
+		void TrimChunks();
+		bool IsGoodTarget(int _tileX, int _tileY, int _fromIndex, glm::vec2 _fromPos, glm::vec2 _centre, float _radius, float _minDistance);
+		void FillPath(SearchContext &_context, Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner);
+
+		template<class Algorithm, class Connectivity, class CostModel>
+		int SearchKernel(SearchContext &_context, OpenList *_openList, int _endIndex, int _maxExpansions, int &_numOps);
+
+		unsigned char CalcNeighbourMask(int _nodeX, int _nodeY);
+		void UpdateLinksTo(int _nodeIndex);
+		void UpdateDiagDependents();
+
+		template<class Table>
+		Table* BuildOnce(atomic<Table*> &_table);
+
+		JumpPointSearch* GetJumpPointSearch();
+		ClusterGraph* GetClusterGraph();
+
 		float m_mapWidth, m_mapHeight;
 		float m_tileWidth, m_tileHeight;
 		int m_numXTiles, m_numYTiles;
 
-		bool m_showGrid, m_showTileVals, m_allowDiags;
+		bool m_allowDiags;
+		bool m_useLandmarks;
+
+		int m_dirOffsets[NUM_DIRECTIONS];
+		float m_dirLengths[NUM_DIRECTIONS];
+
+		ChunkStore *m_mapNodes;
+		vector<unsigned char> m_neighbourMasks;
+		unsigned char m_activeDirs;
+		bool m_edgesDirty;
+
+		float m_bucketWidth;
+		unsigned int m_mapVersion;
+		unsigned int m_terrainVersion;
+
+		vector<MapChange> m_changeLog;
+		int m_changeLogHead;
+		unsigned int m_forgottenVersion;
 
-		Node **m_mapNodes;
-		vector<Node*> **m_nodeLinks;
+		SearchContext m_searchContext;
+		vector<unique_ptr<SearchContext>> m_workerContexts;
+		ThreadPool *m_threadPool;
+		PathQueue *m_pathQueue;
+		PathCache *m_pathCache;
+		PathWatcher *m_pathWatcher;
+		BidirectionalSearch *m_bidirectionalSearch;
+		DistanceField *m_distanceFields[2];
+		OccupancyMap *m_occupancy;
 
-		vector<Node*> m_openNodeList, m_closedNodeList;
+		// Tables covering the whole map that are only built the first time something uses them
+		atomic<JumpPointSearch*> m_jumpPointSearch;
+		atomic<ClusterGraph*> m_clusterGraph;
+		atomic<ConnectedComponents*> m_components;
+		atomic<Landmarks*> m_landmarks;
+		mutex m_buildMutex;
 
-		ALLEGRO_BITMAP *m_baseTiles;
-		ALLEGRO_FONT *m_font;		
+		shared_timed_mutex m_mapMutex;
+		int m_editsWaiting;
+		mutex m_editsMutex;
+		condition_variable m_editsCondition;
 };
 
 #endif
\ No newline at end of file
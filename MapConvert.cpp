@@ -0,0 +1,57 @@
+// Converts a text map, one row of whitespace separated tile types per line, into the binary map format that
+// Map::LoadMap memory-maps. The map is loaded back after it is written to check every tile matches.
+//
+// This file has its own main and is built as a separate executable from Main.cpp, linked only against MapFile.
+//
+// Usage: MapConvert <text map> <binary map>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MapFile.h"
+
+int main(int argc, char *argv[])
+{
+	if(argc != 3)
+	{
+		std::cerr << "Usage: MapConvert <text map> <binary map>" << std::endl;
+		return 1;
+	}
+
+	int numXTiles, numYTiles;
+	std::vector<int> tileTypes;
+
+	if(!MapFile::ReadTextMap(argv[1], numXTiles, numYTiles, tileTypes))
+	{
+		std::cerr << "Could not read text map: " << argv[1] << std::endl;
+		return 1;
+	}
+
+	if(!MapFile::WriteBinaryMap(argv[2], numXTiles, numYTiles, tileTypes))
+	{
+		std::cerr << "Could not write binary map: " << argv[2] << std::endl;
+		return 1;
+	}
+
+	// Reads the new file back to make sure it holds the same map
+	MapFile mapFile;
+
+	if(!mapFile.Open(argv[2]) || mapFile.GetNumXTiles() != numXTiles || mapFile.GetNumYTiles() != numYTiles)
+	{
+		std::cerr << "The binary map could not be read back: " << argv[2] << std::endl;
+		return 1;
+	}
+
+	for(int i = 0; i < numXTiles * numYTiles; i++)
+	{
+		if(mapFile.GetTileType(i) != tileTypes[i])
+		{
+			std::cerr << "Tile " << i << " does not match in the binary map" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Wrote " << numXTiles << "x" << numYTiles << " map to " << argv[2] << std::endl;
+
+	return 0;
+}
\ No newline at end of file
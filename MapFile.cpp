@@ -0,0 +1,283 @@
+#include "MapFile.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Constructor - initialises member variables
+MapFile::MapFile()
+{
+	m_data = nullptr;
+	m_size = 0;
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+	m_header = nullptr;
+	m_tileTypes = nullptr;
+	m_tiles = nullptr;
+}
+
+// Destructor - unmaps the file if it is still open
+MapFile::~MapFile()
+{
+	Close();
+}
+
+// Getters
+
+bool MapFile::IsOpen() { return m_header != nullptr; }
+int MapFile::GetNumXTiles() { return m_header->numXTiles; }
+int MapFile::GetNumYTiles() { return m_header->numYTiles; }
+
+// Returns the type of the tile at the given node index
+int MapFile::GetTileType(int _nodeIndex) { return m_tileTypes[m_tiles[_nodeIndex]]; }
+
+// Maps the given file into memory and checks it is a complete binary map. Returns false, leaving nothing open,
+// if the file can't be mapped or isn't a binary map. Anything opened before a failed step is closed again
+bool MapFile::Open(const std::string &_fileName)
+{
+	Close();
+
+	if(!MapView(_fileName))
+	{
+		Close();
+		return false;
+	}
+
+	if(!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+// Unmaps the file and closes it
+void MapFile::Close()
+{
+#ifdef _WIN32
+	if(m_data != nullptr)
+		UnmapViewOfFile(m_data);
+
+	if(m_mappingHandle != nullptr)
+		CloseHandle(m_mappingHandle);
+
+	if(m_fileHandle != nullptr)
+		CloseHandle(m_fileHandle);
+#else
+	if(m_data != nullptr)
+		munmap((void*)m_data, m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+	m_header = nullptr;
+	m_tileTypes = nullptr;
+	m_tiles = nullptr;
+}
+
+// Maps the whole of the given file into memory as read only. Returns false if it can't be opened or is empty
+bool MapFile::MapView(const std::string &_fileName)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+
+	m_fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		return false;
+
+	m_size = (size_t)fileSize.QuadPart;
+	m_mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if(m_mappingHandle == nullptr)
+		return false;
+
+	m_data = (const unsigned char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	return m_data != nullptr;
+#else
+	int file = open(_fileName.c_str(), O_RDONLY);
+
+	if(file < 0)
+		return false;
+
+	struct stat fileStats;
+
+	if(fstat(file, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void *data = mmap(nullptr, fileStats.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// The mapping stays valid after the file is closed
+	close(file);
+
+	if(data == MAP_FAILED)
+		return false;
+
+	m_data = (const unsigned char*)data;
+	m_size = fileStats.st_size;
+
+	return true;
+#endif
+}
+
+// Checks the mapped file has the binary map header and is long enough to hold the tile type table and every
+// tile, that every entry in the table is a tile type the game knows and that every tile refers to an entry in
+// the table. Sets up the pointers into the file if it does
+bool MapFile::Validate()
+{
+	if(m_size < sizeof(MapFileHeader))
+		return false;
+
+	const MapFileHeader *header = (const MapFileHeader*)m_data;
+
+	if(memcmp(header->magic, c_mapFileMagic, sizeof(c_mapFileMagic)) != 0 || header->version != c_mapFileVersion)
+		return false;
+
+	if(header->numTileTypes == 0 || header->numTileTypes > (uint32_t)c_maxMapFileTileTypes)
+		return false;
+
+	unsigned long long numTiles = (unsigned long long)header->numXTiles * header->numYTiles;
+	size_t tilesOffset = sizeof(MapFileHeader) + header->numTileTypes * sizeof(int32_t);
+
+	if(numTiles == 0 || m_size < tilesOffset || m_size - tilesOffset < numTiles)
+		return false;
+
+	const int32_t *tileTypes = (const int32_t*)(m_data + sizeof(MapFileHeader));
+
+	for(uint32_t i = 0; i < header->numTileTypes; i++)
+	{
+		if(tileTypes[i] < 0 || tileTypes[i] >= c_numTerrainTypes)
+		{
+			std::cerr << "Binary map has unknown tile type " << tileTypes[i] << std::endl;
+			return false;
+		}
+	}
+
+	const unsigned char *tiles = m_data + tilesOffset;
+
+	for(unsigned long long i = 0; i < numTiles; i++)
+	{
+		if(tiles[i] >= header->numTileTypes)
+			return false;
+	}
+
+	m_header = header;
+	m_tileTypes = tileTypes;
+	m_tiles = tiles;
+
+	return true;
+}
+
+// Reads a text map into a row-major list of tile types. Tile types can have any number of digits. Blank lines
+// are skipped and the first row sets the width of the map. Returns false if the file can't be opened, has
+// no tiles, has a row of a different width or has a tile type the game doesn't know
+bool MapFile::ReadTextMap(const std::string &_fileName, int &_numXTiles, int &_numYTiles, std::vector<int> &_tileTypes)
+{
+	std::ifstream inFile(_fileName);
+
+	if(!inFile.good())
+		return false;
+
+	std::string inData;
+	int tileType;
+
+	_numXTiles = 0;
+	_numYTiles = 0;
+	_tileTypes.clear();
+
+	while(std::getline(inFile, inData))
+	{
+		std::stringstream tempStream(inData);
+		int numColumns = 0;
+
+		while(tempStream >> tileType)
+		{
+			if(tileType < 0 || tileType >= c_numTerrainTypes)
+			{
+				std::cerr << "Unknown tile type " << tileType << " in map file " << _fileName << std::endl;
+				return false;
+			}
+
+			_tileTypes.push_back(tileType);
+			numColumns++;
+		}
+
+		if(numColumns == 0)
+			continue;
+
+		if(_numYTiles == 0)
+			_numXTiles = numColumns;
+
+		else if(numColumns != _numXTiles)
+			return false;
+
+		_numYTiles++;
+	}
+
+	return _numYTiles > 0;
+}
+
+// Writes the tiles as a binary map, building the tile type table from the types that are used. Returns false
+// if the map uses more tile types than the table can hold or the file can't be written
+bool MapFile::WriteBinaryMap(const std::string &_fileName, int _numXTiles, int _numYTiles, const std::vector<int> &_tileTypes)
+{
+	std::vector<int32_t> typeTable;
+	std::vector<unsigned char> tiles(_tileTypes.size());
+
+	for(unsigned int i = 0; i < _tileTypes.size(); i++)
+	{
+		unsigned int entry = 0;
+
+		while(entry < typeTable.size() && typeTable[entry] != _tileTypes[i])
+			entry++;
+
+		if(entry == typeTable.size())
+		{
+			if(typeTable.size() == c_maxMapFileTileTypes)
+				return false;
+
+			typeTable.push_back(_tileTypes[i]);
+		}
+
+		tiles[i] = (unsigned char)entry;
+	}
+
+	MapFileHeader header;
+	memcpy(header.magic, c_mapFileMagic, sizeof(c_mapFileMagic));
+	header.version = c_mapFileVersion;
+	header.numXTiles = _numXTiles;
+	header.numYTiles = _numYTiles;
+	header.numTileTypes = typeTable.size();
+
+	std::ofstream outFile(_fileName, std::ios::binary);
+
+	if(!outFile.good())
+		return false;
+
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)typeTable.data(), typeTable.size() * sizeof(int32_t));
+	outFile.write((const char*)tiles.data(), tiles.size());
+
+	return outFile.good();
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Identifies a binary map file and the version of the layout it was written with
+const char c_mapFileMagic[4] = { 'A', 'M', 'A', 'P' };
+const uint32_t c_mapFileVersion = 1;
+
+// Start of a binary map file. It is followed by the tile type table, one 32 bit tile type for each entry, and
+// then one byte per tile in row-major order giving the position of the tile's type in the table. The fields are
+// stored in the byte order of the machine that wrote the file, so a file from a machine with the other byte
+// order fails the version check
+struct MapFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t numXTiles;
+	uint32_t numYTiles;
+	uint32_t numTileTypes;
+};
+
+// Number of tile types the game knows about. Grass, road, mud and wall are types 0 to 3
+const int c_numTerrainTypes = 4;
+
+// Most tile types a binary map can use, as each tile stores its position in the table in a single byte
+const int c_maxMapFileTileTypes = 256;
+
+// Read only view of a binary map file. The file is memory-mapped and the tiles are read straight out of the
+// mapping rather than being parsed, so even large maps open in a few milliseconds. Text maps, one row of
+// whitespace separated tile types per line, are read and converted by the static functions
+class MapFile
+{
+	public:
+		// Constructor and destructor
+		MapFile();
+		~MapFile();
+
+		// Getters
+		bool IsOpen();
+		int GetNumXTiles();
+		int GetNumYTiles();
+		int GetTileType(int _nodeIndex);
+
+		bool Open(const std::string &_fileName);
+		void Close();
+
+		static bool ReadTextMap(const std::string &_fileName, int &_numXTiles, int &_numYTiles, std::vector<int> &_tileTypes);
+		static bool WriteBinaryMap(const std::string &_fileName, int _numXTiles, int _numYTiles, const std::vector<int> &_tileTypes);
+
+	private:
+		bool MapView(const std::string &_fileName);
+		bool Validate();
+
+		const unsigned char *m_data;
+		size_t m_size;
+
+		// Operating system handles for the open file and its mapping
+		void *m_fileHandle;
+		void *m_mappingHandle;
+
+		const MapFileHeader *m_header;
+		const int32_t *m_tileTypes;
+		const unsigned char *m_tiles;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "MapRenderer.h"
+
+// Constructor - initialises member variables and loads the tile images
+MapRenderer::MapRenderer(Map *_map)
+{
+	m_map = _map;
+
+	m_showGrid = true;
+	m_showTileVals = false;
+
+	m_baseTiles = al_load_bitmap("Base Tiles.png");
+	m_font = al_load_font("Arial.ttf", 14, 0);
+}
+
+// Destructor - cleans up necessary objects to prevent memory leaks
+MapRenderer::~MapRenderer()
+{
+	al_destroy_bitmap(m_baseTiles);
+	al_destroy_font(m_font);
+}
+
+// Setters
+
+void MapRenderer::ToggleGrid() { m_showGrid = !m_showGrid; }
+void MapRenderer::ToggleTileVals() { m_showTileVals = !m_showTileVals; }
+
+// Renders the map to the screen along with the grid and tile values if necessary
+void MapRenderer::DrawMap()
+{
+	int numXTiles = m_map->GetNumXTiles();
+	int numYTiles = m_map->GetNumYTiles();
+	float tileWidth = m_map->GetTileWidth();
+	float tileHeight = m_map->GetTileHeight();
+
+	for (int y = 0; y < numYTiles; y++)
+	{
+		for(int x = 0; x < numXTiles; x++)
+		{
+			Node &node = m_map->GetNode(y * numXTiles + x);
+
+			al_draw_scaled_bitmap(m_baseTiles, 75 * node.GetTileType(), 0, 75, 75, x * tileWidth, y * tileHeight, tileWidth, tileHeight, 0);
+
+			if(m_showTileVals)
+				al_draw_textf(m_font, al_map_rgb(0,0,255), x * tileWidth + tileWidth * 0.3, y * tileHeight + tileHeight * 0.3, 0, "%f", node.GetTileCost());
+		}		
+	}
+
+	// Draws a grid over the top of the map if it is active
+	if(m_showGrid)
+	{
+		for (int y = 0; y < numYTiles; y++)
+		{
+			for (int x = 0; x < numXTiles; x++)
+			{
+				al_draw_line(x * tileWidth, 0, x * tileWidth, numYTiles * tileHeight, al_map_rgb(0,0,0), 1); 
+			}
+
+			al_draw_line(0, y * tileHeight, numXTiles * tileWidth, y * tileHeight, al_map_rgb(0,0,0), 1); 
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef MAPRENDERER_H
+#define MAPRENDERER_H
+
+#include <allegro5\allegro_primitives.h>
+#include <allegro5\allegro_font.h>
+#include "Map.h"
+
+// Draws a map with Allegro. The map itself knows nothing about drawing, so it can be used without Allegro
+// and only the game creates one of these
+class MapRenderer
+{
+	public:
+		// Constructor and destructor
+		MapRenderer(Map *_map);
+		~MapRenderer();
+
+		// Setters
+		void ToggleGrid();
+		void ToggleTileVals();
+
+		void DrawMap();
+
+	private:
+		bool m_showGrid, m_showTileVals;
+
+		Map *m_map;
+
+		ALLEGRO_BITMAP *m_baseTiles;
+		ALLEGRO_FONT *m_font;
+};
+
+#endif
\ No newline at end of file
@@ -3,12 +3,7 @@
 // Constructor - initialises member variables
 Node::Node()
 {
-	m_fCost = 0;
-	m_gCost = 0;
-	m_pathParent = nullptr;
-	m_changedSincePath = false;
-	m_hasEnemy = false;
-	m_enemyAdjacent = false;
+	m_changeVersion = 0;
 }
 
 // Destructor - deletes necessary objects to prevent memory leaks
@@ -16,52 +11,55 @@ Node::~Node() {}
 
 // Getters
 
-bool Node::HasChanged() { return m_changedSincePath; }
+// Returns whether the node has been changed since the map was at the given version
+bool Node::HasChangedSince(unsigned int _version) { return m_changeVersion > _version; }
+
 bool Node::IsTraversable() { return m_traversable; }
-bool Node::GetEnemyOn() { return m_hasEnemy; }
-bool Node::GetEnemyAdj() { return m_enemyAdjacent; }
 
 int Node::GetNodeIndex() { return m_nodeIndex; }
 int Node::GetTileType() { return m_tileType; }
 int Node::GetTileX() { return m_tileX; }
 int Node::GetTileY() { return m_tileY; }
 
-float Node::GetFCost() { return m_fCost; }
-float Node::GetGCost() { return m_gCost; }
 float Node::GetTileCost() {	return m_terrainCost; }
 
-Node* Node::GetParent() { return m_pathParent; }
 glm::vec2 Node::GetPos() { return m_pos; }
 
-// Setters
-
-void Node::SetNodeIndex(int _nodeIndex) { m_nodeIndex = _nodeIndex; }
-void Node::UpdateFCost(float _distToEnd) { m_fCost = m_gCost + _distToEnd; }
-
-// Updates the G cost of this node. Takes in the G and terrain cost of the parent so that the G cost of this
-// node can use half of the terrain cost of the previous node and half of the terrain cost of this node. This
+// Calculates the G cost this node would have if it were reached from a parent with the given G and terrain costs.
+// Half of the terrain cost of the previous node and half of the terrain cost of this node are used. This
 // gives a more accurate path when moving over changing terrain
-void Node::UpdateGCost(float _gCost, float _parentTerrainCost, float _parentGCost, bool _isPlayer)
+float Node::CalcGCost(float _gCost, float _parentTerrainCost, float _parentGCost, bool _isPlayer, float _occupancyScale)
 {
-	if(_isPlayer && m_hasEnemy)
-		m_gCost = ((_gCost/2) * m_terrainCost * 100.0f) + ((_gCost/2 * _parentTerrainCost)) + _parentGCost;
+	if(_isPlayer)
+		return CalcPlayerGCost(_gCost, _parentTerrainCost, _parentGCost, _occupancyScale);
 
-	else if(_isPlayer && m_enemyAdjacent)
-		m_gCost = ((_gCost/2) * m_terrainCost * 50.0f) + ((_gCost/2 * _parentTerrainCost)) + _parentGCost;
+	return CalcEnemyGCost(_gCost, _parentTerrainCost, _parentGCost);
+}
 
-	else
-		m_gCost = ((_gCost/2) * m_terrainCost) + ((_gCost/2 * _parentTerrainCost)) + _parentGCost;
+// Calculates the G cost for the player, who avoids nodes near enemies. The terrain cost of this node is scaled
+// by the multiplier the map's occupancy layer gives it, which is one away from any enemy
+float Node::CalcPlayerGCost(float _gCost, float _parentTerrainCost, float _parentGCost, float _occupancyScale)
+{
+	return ((_gCost/2) * m_terrainCost * _occupancyScale) + ((_gCost/2 * _parentTerrainCost)) + _parentGCost;
 }
 
-void Node::UpdateParent(Node *_parent) { m_pathParent = _parent; }
+// Calculates the G cost for an enemy, which only pays for the terrain
+float Node::CalcEnemyGCost(float _gCost, float _parentTerrainCost, float _parentGCost)
+{
+	return ((_gCost/2) * m_terrainCost) + ((_gCost/2 * _parentTerrainCost)) + _parentGCost;
+}
+
+// Setters
+
+void Node::SetNodeIndex(int _nodeIndex) { m_nodeIndex = _nodeIndex; }
 
-// Updates the tile type and flags that the tile has been changed
-// which is checked when a path is generated.
-void Node::UpdateTerrain(int _terrainType)
+// Updates the tile type and records the map version it was changed at
+// which is checked against the version a path was generated at.
+void Node::UpdateTerrain(int _terrainType, unsigned int _version)
 {
 	m_tileType = _terrainType;
 
-	m_changedSincePath = true;
+	m_changeVersion = _version;
 
 	switch(m_tileType)
 	{
@@ -73,6 +71,10 @@ void Node::UpdateTerrain(int _terrainType)
 			break;
 		case 3: m_terrainCost = 10.0f;
 			break;
+		// Unknown types are made into walls so nothing walks on them or draws past the end of the tileset
+		default: m_tileType = 3;
+			m_terrainCost = 10.0f;
+			break;
 	}
 
 	// If the terrain is number 3 it is not traversable and the flag is set
@@ -82,36 +84,6 @@ void Node::UpdateTerrain(int _terrainType)
 		m_traversable = true;
 }
 
-// Increments the enemy counter on the node and states that it has been changed
-void Node::AddEnemy()
-{
-	m_numEnemies++;
-	m_changedSincePath = true;
-}
-
-// Decrements the enemy counter on the node and states that it has been changed
-// If the counter is at zero it returns false and if there are enemies still on
-// the node it returns true
-bool Node::RemoveEnemy()
-{
-	m_numEnemies--;
-
-	if(m_numEnemies == 0)
-	{
-		m_changedSincePath = true;
-		return false;
-	}
-	else
-		return true;
-}
-
-// Toggles whether this node is adjacent to a node containing an enemy and states the node has been changed
-void Node::ToggleEnemyAdjacent()
-{
-	m_enemyAdjacent = !m_enemyAdjacent;
-	m_changedSincePath = true;
-}
-
 // Adds data to the node object based on the provided parameters
 void Node::CreateNode(int _nodeIndex, int _tileType, float _xPos, float _yPos, int _mapWidth)
 {
@@ -141,19 +113,10 @@ void Node::CreateNode(int _nodeIndex, int _tileType, float _xPos, float _yPos, i
 			break;
 		case 3: m_terrainCost = 10.0f;
 			break;
+		// Unknown types are made into walls so nothing walks on them or draws past the end of the tileset
+		default: m_tileType = 3;
+			m_terrainCost = 10.0f;
+			m_traversable = false;
+			break;
 	}
-}
-
-// Resets the data on the node used by the pathfinding algorithm
-void Node::ResetNode()
-{
-	m_fCost = 0;
-	m_gCost = 0;
-	m_pathParent = nullptr;
-	m_changedSincePath = false;
-}
-void Node::ClearNode()
-{
-	m_enemyAdjacent = false;
-	m_hasEnemy = false;
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "OccupancyMap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Constructor - initialises member variables with no entities on the map
+OccupancyMap::OccupancyMap(int _numXTiles, int _numYTiles)
+{
+	m_numXTiles = _numXTiles;
+	m_numYTiles = _numYTiles;
+
+	int numNodes = _numXTiles * _numYTiles;
+
+	m_occupants.assign(numNodes, 0);
+	m_appliedOccupied.assign(numNodes, 0);
+	m_costScales.assign(numNodes, 1.0f);
+	m_marked.assign(numNodes, 0);
+
+	m_radius = 0;
+	m_influenceChanged = false;
+	SetInfluence(c_defaultInfluenceRadius, c_defaultInfluenceFalloff);
+}
+
+// Destructor
+OccupancyMap::~OccupancyMap() {}
+
+// Getters
+
+// Returns whether entities have moved since the changes were last applied
+bool OccupancyMap::HasPendingChanges() { return !m_pendingTiles.empty(); }
+
+int OccupancyMap::GetNumOccupants(int _nodeIndex) { return m_occupants[_nodeIndex]; }
+int OccupancyMap::GetInfluenceRadius() { return m_radius; }
+float OccupancyMap::GetInfluenceFalloff() { return m_falloff; }
+
+// Returns the multiplier on the terrain cost of moving onto the tile, which is one if no entity is in range
+float OccupancyMap::GetCostScale(int _nodeIndex) { return m_costScales[_nodeIndex]; }
+
+// Setters
+
+// Sets how many tiles around an occupied tile cost extra and how quickly the extra cost falls off. The defaults
+// give a tile with an entity on it and the tiles next to it the same costs the nodes used to give them. Every
+// occupied tile is worked out again with the next batch of changes
+void OccupancyMap::SetInfluence(int _radius, float _falloff)
+{
+	_radius = std::max(_radius, 0);
+
+	m_dirtyRadius = std::max(m_radius, _radius);
+	m_radius = _radius;
+	m_falloff = _falloff;
+
+	m_influence.resize(m_radius + 1);
+	m_influence[0] = c_occupiedCostScale;
+
+	for(int distance = 1; distance <= m_radius; distance++)
+		m_influence[distance] = 1.0f + (c_adjacentCostScale - 1.0f) * pow(m_falloff, (float)(distance - 1));
+
+	for(unsigned int i = 0; i < m_occupants.size(); i++)
+	{
+		if(m_appliedOccupied[i])
+			MarkPending(i);
+	}
+
+	m_influenceChanged = true;
+}
+
+// Counts an entity moving onto the tile
+void OccupancyMap::AddOccupant(int _nodeIndex)
+{
+	m_occupants[_nodeIndex]++;
+	MarkPending(_nodeIndex);
+}
+
+// Counts an entity moving off the tile. Entities forgotten by Clear aren't counted, so removing one of them
+// leaves the tile empty
+void OccupancyMap::RemoveOccupant(int _nodeIndex)
+{
+	if(m_occupants[_nodeIndex] == 0)
+		return;
+
+	m_occupants[_nodeIndex]--;
+	MarkPending(_nodeIndex);
+}
+
+// Applies every move made since the last batch. Tiles that have become occupied or empty are added to the list
+// of changed sources, and the cost of every tile in range of them is worked out again, with the tiles whose
+// cost changed added to the other list. An entity that moved off a tile and back again within the batch changes
+// nothing. Returns how far around each changed source costs may have changed
+int OccupancyMap::ApplyChanges(std::vector<int> &_changedSources, std::vector<int> &_changedTiles)
+{
+	for(int tile : m_pendingTiles)
+	{
+		m_marked[tile] = 0;
+
+		char occupied = m_occupants[tile] > 0 ? 1 : 0;
+
+		if(occupied == m_appliedOccupied[tile] && !m_influenceChanged)
+			continue;
+
+		m_appliedOccupied[tile] = occupied;
+		_changedSources.push_back(tile);
+	}
+
+	m_pendingTiles.clear();
+
+	int radius = m_dirtyRadius;
+
+	m_dirtyRadius = m_radius;
+	m_influenceChanged = false;
+
+	// The areas around sources close to each other overlap, so each tile is only worked out once and marked
+	// until the end of the batch
+	std::vector<int> visited;
+
+	for(int source : _changedSources)
+	{
+		int sourceX = source % m_numXTiles;
+		int sourceY = source / m_numXTiles;
+
+		for(int y = std::max(sourceY - radius, 0); y <= std::min(sourceY + radius, m_numYTiles - 1); y++)
+		{
+			for(int x = std::max(sourceX - radius, 0); x <= std::min(sourceX + radius, m_numXTiles - 1); x++)
+			{
+				int nodeIndex = y * m_numXTiles + x;
+
+				if(m_marked[nodeIndex])
+					continue;
+
+				m_marked[nodeIndex] = 1;
+				visited.push_back(nodeIndex);
+
+				float scale = CalcCostScale(x, y);
+
+				if(scale != m_costScales[nodeIndex])
+				{
+					m_costScales[nodeIndex] = scale;
+					_changedTiles.push_back(nodeIndex);
+				}
+			}
+		}
+	}
+
+	for(int nodeIndex : visited)
+		m_marked[nodeIndex] = 0;
+
+	return radius;
+}
+
+// Forgets every entity on the map. Their costs are taken off with the next batch of changes
+void OccupancyMap::Clear()
+{
+	for(unsigned int i = 0; i < m_occupants.size(); i++)
+	{
+		if(m_occupants[i] > 0)
+		{
+			m_occupants[i] = 0;
+			MarkPending(i);
+		}
+	}
+}
+
+// Adds the tile to the list of tiles to check in the next batch, unless it is already on it
+void OccupancyMap::MarkPending(int _nodeIndex)
+{
+	if(m_marked[_nodeIndex])
+		return;
+
+	m_marked[_nodeIndex] = 1;
+	m_pendingTiles.push_back(_nodeIndex);
+}
+
+// Works out the cost multiplier of a tile from the occupied tiles in range of it as of the last batch
+float OccupancyMap::CalcCostScale(int _tileX, int _tileY)
+{
+	float scale = 1.0f;
+
+	for(int y = std::max(_tileY - m_radius, 0); y <= std::min(_tileY + m_radius, m_numYTiles - 1); y++)
+	{
+		for(int x = std::max(_tileX - m_radius, 0); x <= std::min(_tileX + m_radius, m_numXTiles - 1); x++)
+		{
+			if(m_appliedOccupied[y * m_numXTiles + x])
+				scale = std::max(scale, m_influence[std::max(abs(x - _tileX), abs(y - _tileY))]);
+		}
+	}
+
+	return scale;
+}
\ No newline at end of file
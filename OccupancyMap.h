@@ -0,0 +1,65 @@
+#ifndef OCCUPANCYMAP_H
+#define OCCUPANCYMAP_H
+
+#include <vector>
+
+// Multiplier on the terrain cost of moving onto a tile with an entity on it
+const float c_occupiedCostScale = 100.0f;
+
+// Multiplier on the terrain cost of moving onto a tile next to an occupied tile
+const float c_adjacentCostScale = 50.0f;
+
+// Default number of tiles around an occupied tile that cost extra to move onto, and the fraction of the extra
+// cost that is kept for each tile further away than the adjacent ones
+const int c_defaultInfluenceRadius = 1;
+const float c_defaultInfluenceFalloff = 0.5f;
+
+// Layer of extra movement costs caused by the entities on the map, kept apart from the terrain so that entities
+// moving around never change the nodes. Each tile counts the entities on it, and the cost of every tile within
+// the influence radius of an occupied tile is scaled by an amount that falls off with distance, taking the
+// largest scale of any occupied tile in range. Entities are added and removed as they move, but the costs are
+// only worked out again when the changes are applied, once for the whole batch. The counts are only used by the
+// thread moving the entities, and the costs are only changed while the map is locked for editing
+class OccupancyMap
+{
+	public:
+		// Constructor and destructor
+		OccupancyMap(int _numXTiles, int _numYTiles);
+		~OccupancyMap();
+
+		// Getters
+		bool HasPendingChanges();
+		int GetNumOccupants(int _nodeIndex);
+		int GetInfluenceRadius();
+		float GetInfluenceFalloff();
+		float GetCostScale(int _nodeIndex);
+
+		// Setters
+		void SetInfluence(int _radius, float _falloff);
+
+		void AddOccupant(int _nodeIndex);
+		void RemoveOccupant(int _nodeIndex);
+		int ApplyChanges(std::vector<int> &_changedSources, std::vector<int> &_changedTiles);
+		void Clear();
+
+	private:
+		void MarkPending(int _nodeIndex);
+		float CalcCostScale(int _tileX, int _tileY);
+
+		int m_numXTiles, m_numYTiles;
+
+		int m_radius;
+		int m_dirtyRadius;
+		float m_falloff;
+		std::vector<float> m_influence;
+
+		std::vector<int> m_occupants;
+		std::vector<char> m_appliedOccupied;
+		std::vector<float> m_costScales;
+
+		std::vector<char> m_marked;
+		std::vector<int> m_pendingTiles;
+		bool m_influenceChanged;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "OpenList.h"
+
+// Binary heap open list
+
+// Constructor and destructor
+BinaryHeapOpenList::BinaryHeapOpenList() {}
+BinaryHeapOpenList::~BinaryHeapOpenList() {}
+
+// Getters
+
+bool BinaryHeapOpenList::IsEmpty() { return m_heap.empty(); }
+bool BinaryHeapOpenList::Contains(int _nodeIndex) { return m_heapPositions[_nodeIndex] != -1; }
+
+// Returns the index of the cheapest node without removing it
+int BinaryHeapOpenList::PeekLowest() { return m_heap.front(); }
+
+// Setters
+
+// Empties the heap ready for a new search. Only the nodes still on the heap need their positions
+// clearing as every popped node has already been cleared, so this does not touch the whole map
+void BinaryHeapOpenList::Reset(int _numNodes)
+{
+	for(int nodeIndex : m_heap)
+		m_heapPositions[nodeIndex] = -1;
+
+	m_heap.clear();
+	m_costs.clear();
+
+	if((int)m_heapPositions.size() != _numNodes)
+		m_heapPositions.assign(_numNodes, -1);
+}
+
+// Adds a node to the bottom of the heap and moves it up until its parent is cheaper
+void BinaryHeapOpenList::Push(int _nodeIndex, float _cost)
+{
+	m_heap.push_back(_nodeIndex);
+	m_costs.push_back(_cost);
+	m_heapPositions[_nodeIndex] = m_heap.size() - 1;
+
+	SiftUp(m_heap.size() - 1);
+}
+
+// Lowers the cost of a node already on the heap and moves it up to its new position
+void BinaryHeapOpenList::DecreaseKey(int _nodeIndex, float _cost)
+{
+	int heapPos = m_heapPositions[_nodeIndex];
+
+	m_costs[heapPos] = _cost;
+	SiftUp(heapPos);
+}
+
+// Removes the cheapest node from the top of the heap and returns its index. The last node is
+// moved to the top and sifted down to restore the heap
+int BinaryHeapOpenList::PopLowest()
+{
+	int lowest = m_heap.front();
+
+	Swap(0, m_heap.size() - 1);
+	m_heap.pop_back();
+	m_costs.pop_back();
+	m_heapPositions[lowest] = -1;
+
+	if(!m_heap.empty())
+		SiftDown(0);
+
+	return lowest;
+}
+
+// Moves the entry at the given position up the heap while it is cheaper than its parent
+void BinaryHeapOpenList::SiftUp(int _heapPos)
+{
+	while(_heapPos > 0)
+	{
+		int parentPos = (_heapPos - 1) / 2;
+
+		if(m_costs[parentPos] <= m_costs[_heapPos])
+			break;
+
+		Swap(parentPos, _heapPos);
+		_heapPos = parentPos;
+	}
+}
+
+// Moves the entry at the given position down the heap while either child is cheaper than it
+void BinaryHeapOpenList::SiftDown(int _heapPos)
+{
+	int heapSize = m_heap.size();
+
+	while(true)
+	{
+		int left = _heapPos * 2 + 1;
+		int right = left + 1;
+		int smallest = _heapPos;
+
+		if(left < heapSize && m_costs[left] < m_costs[smallest])
+			smallest = left;
+
+		if(right < heapSize && m_costs[right] < m_costs[smallest])
+			smallest = right;
+
+		if(smallest == _heapPos)
+			break;
+
+		Swap(smallest, _heapPos);
+		_heapPos = smallest;
+	}
+}
+
+// Swaps two entries in the heap and updates the stored positions of both nodes
+void BinaryHeapOpenList::Swap(int _first, int _second)
+{
+	int tempNode = m_heap[_first];
+	float tempCost = m_costs[_first];
+
+	m_heap[_first] = m_heap[_second];
+	m_costs[_first] = m_costs[_second];
+	m_heap[_second] = tempNode;
+	m_costs[_second] = tempCost;
+
+	m_heapPositions[m_heap[_first]] = _first;
+	m_heapPositions[m_heap[_second]] = _second;
+}
+
+// Bucket open list
+
+// Constructor - initialises member variables
+BucketOpenList::BucketOpenList()
+{
+	m_bucketWidth = 1.0f;
+	m_numEntries = 0;
+	m_currBucket = 0;
+	m_highestBucket = -1;
+}
+
+// Destructor
+BucketOpenList::~BucketOpenList() {}
+
+// Getters
+
+bool BucketOpenList::IsEmpty() { return m_numEntries == 0; }
+bool BucketOpenList::Contains(int _nodeIndex) { return m_nodeBuckets[_nodeIndex] != -1; }
+
+// Walks forward from the current bucket to the first one holding a live entry and returns it without
+// removing it. Entries left behind by DecreaseKey are dropped on the way
+int BucketOpenList::PeekLowest()
+{
+	while(true)
+	{
+		std::vector<int> &bucket = m_buckets[m_currBucket];
+
+		while(!bucket.empty() && m_nodeBuckets[bucket.back()] != m_currBucket)
+			bucket.pop_back();
+
+		if(!bucket.empty())
+			return bucket.back();
+
+		m_currBucket++;
+	}
+}
+
+// Setters
+
+void BucketOpenList::SetBucketWidth(float _width) { m_bucketWidth = _width; }
+
+// Empties every bucket that was used by the last search. The bucket vectors keep their memory so
+// that later searches do not have to allocate
+void BucketOpenList::Reset(int _numNodes)
+{
+	for(int n = 0; n <= m_highestBucket; n++)
+	{
+		for(int nodeIndex : m_buckets[n])
+			m_nodeBuckets[nodeIndex] = -1;
+
+		m_buckets[n].clear();
+	}
+
+	m_numEntries = 0;
+	m_currBucket = 0;
+	m_highestBucket = -1;
+
+	if((int)m_nodeBuckets.size() != _numNodes)
+		m_nodeBuckets.assign(_numNodes, -1);
+}
+
+// Adds the node to the bucket for its cost
+void BucketOpenList::Push(int _nodeIndex, float _cost)
+{
+	int bucket = GetBucket(_cost);
+
+	m_buckets[bucket].push_back(_nodeIndex);
+	m_nodeBuckets[_nodeIndex] = bucket;
+	m_numEntries++;
+}
+
+// Moves the node into the bucket for its new cost. The old entry is left where it is and is skipped
+// when it is reached because the node's bucket no longer matches it
+void BucketOpenList::DecreaseKey(int _nodeIndex, float _cost)
+{
+	int bucket = GetBucket(_cost);
+
+	if(bucket == m_nodeBuckets[_nodeIndex])
+		return;
+
+	m_buckets[bucket].push_back(_nodeIndex);
+	m_nodeBuckets[_nodeIndex] = bucket;
+}
+
+// Finds the first live entry from the current bucket onwards and removes it
+int BucketOpenList::PopLowest()
+{
+	int nodeIndex = PeekLowest();
+
+	m_buckets[m_currBucket].pop_back();
+	m_nodeBuckets[nodeIndex] = -1;
+	m_numEntries--;
+
+	return nodeIndex;
+}
+
+// Returns the bucket for the given cost, adding buckets if needed. Costs below the current bucket
+// (possible when the heuristic overestimates) are placed in the current bucket
+int BucketOpenList::GetBucket(float _cost)
+{
+	int bucket = (int)(_cost / m_bucketWidth);
+
+	if(bucket < m_currBucket)
+		bucket = m_currBucket;
+
+	if(bucket >= (int)m_buckets.size())
+		m_buckets.resize(bucket + 1);
+
+	if(bucket > m_highestBucket)
+		m_highestBucket = bucket;
+
+	return bucket;
+}
\ No newline at end of file
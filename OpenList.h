@@ -0,0 +1,97 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include <vector>
+
+// Types of open list that can be requested for a path query
+enum OpenListType
+{
+	OPEN_LIST_BINARY_HEAP = 0,
+	OPEN_LIST_BUCKET = 1
+};
+
+// Interface for the open list used by the pathfinding algorithms. Nodes are referred to by their node index
+// and are ordered by the cost provided when they are pushed (F cost for A Star, G cost for Dijkstra)
+class OpenList
+{
+	public:
+		virtual ~OpenList() {}
+
+		// Getters
+		virtual bool IsEmpty() = 0;
+		virtual bool Contains(int _nodeIndex) = 0;
+		virtual int PeekLowest() = 0;
+
+		// Setters
+		virtual void Reset(int _numNodes) = 0;
+		virtual void Push(int _nodeIndex, float _cost) = 0;
+		virtual void DecreaseKey(int _nodeIndex, float _cost) = 0;
+		virtual int PopLowest() = 0;
+};
+
+// Indexed binary min-heap. The position of every node in the heap is stored so that a node already
+// on the open list can have its cost lowered and be moved up the heap without searching for it
+class BinaryHeapOpenList : public OpenList
+{
+	public:
+		// Constructor and destructor
+		BinaryHeapOpenList();
+		~BinaryHeapOpenList();
+
+		// Getters
+		virtual bool IsEmpty();
+		virtual bool Contains(int _nodeIndex);
+		virtual int PeekLowest();
+
+		// Setters
+		virtual void Reset(int _numNodes);
+		virtual void Push(int _nodeIndex, float _cost);
+		virtual void DecreaseKey(int _nodeIndex, float _cost);
+		virtual int PopLowest();
+
+	private:
+		void SiftUp(int _heapPos);
+		void SiftDown(int _heapPos);
+		void Swap(int _first, int _second);
+
+		std::vector<int> m_heap;
+		std::vector<float> m_costs;
+		std::vector<int> m_heapPositions;
+};
+
+// Bucket queue that groups nodes by their cost rounded down to a multiple of the bucket width. Pushing and
+// lowering a cost are constant time and popping only has to walk forward to the next non-empty bucket.
+// Nodes within a bucket are not ordered so the result is only as accurate as the bucket width
+class BucketOpenList : public OpenList
+{
+	public:
+		// Constructor and destructor
+		BucketOpenList();
+		~BucketOpenList();
+
+		// Getters
+		virtual bool IsEmpty();
+		virtual bool Contains(int _nodeIndex);
+		virtual int PeekLowest();
+
+		// Setters
+		void SetBucketWidth(float _width);
+		virtual void Reset(int _numNodes);
+		virtual void Push(int _nodeIndex, float _cost);
+		virtual void DecreaseKey(int _nodeIndex, float _cost);
+		virtual int PopLowest();
+
+	private:
+		int GetBucket(float _cost);
+
+		float m_bucketWidth;
+
+		int m_numEntries;
+		int m_currBucket;
+		int m_highestBucket;
+
+		std::vector<std::vector<int>> m_buckets;
+		std::vector<int> m_nodeBuckets;
+};
+
+#endif
\ No newline at end of file
@@ -1,21 +1,96 @@
 #include "Path.h"
-#include "allegro5\allegro_primitives.h"
+#include <mutex>
 
-// Constructor - initialises member variables
+// Names of the algorithms, shown as the message of a path they found
+static const char *const c_algoNames[] = { "A Star", "Dijkstra", "Jump Point Search", "Jump Point Search (precomputed jumps)",
+	"Hierarchical A Star", "D* Lite", "Bidirectional A Star", "Bidirectional Dijkstra" };
+
+// Memory of deleted path objects, which is given back when the program ends
+struct FreePathBlocks
+{
+	std::vector<void*> blocks;
+
+	~FreePathBlocks()
+	{
+		for(void *block : blocks)
+			::operator delete(block);
+	}
+};
+
+// Memory of deleted path objects and the waypoint buffers of deleted paths, kept for the next paths created
+static std::mutex s_poolMutex;
+static FreePathBlocks s_freePaths;
+static std::vector<std::vector<PathPoint>> s_freeBuffers;
+
+// Constructor - initialises member variables and takes a waypoint buffer from the pool if there is one
 Path::Path(bool _playerPath)
 {
-	m_font = al_load_font("Arial.ttf", 14, 0);
+	m_status = PATH_NOT_SEARCHED;
 	m_numOperations = 0;
 	m_pathCalcTime = 0;
-	m_pathMessage = "";
+	m_algoType = ALGO_A_STAR;
+	m_mapVersion = 0;
 	m_playerPath = _playerPath;
+	m_invalidated = false;
+
+	std::lock_guard<std::mutex> lock(s_poolMutex);
+
+	if(!s_freeBuffers.empty())
+	{
+		m_path.swap(s_freeBuffers.back());
+		s_freeBuffers.pop_back();
+	}
 }
 
-// Destructor - frees up necessary objects to prevent memory leaks
+// Destructor - gives the waypoint buffer back to the pool, keeping its memory, unless the pool is full
 Path::~Path()
 {
-	al_destroy_font(m_font);
 	m_path.clear();
+
+	std::lock_guard<std::mutex> lock(s_poolMutex);
+
+	if(m_path.capacity() > 0 && (int)s_freeBuffers.size() < c_maxPooledPaths)
+	{
+		s_freeBuffers.reserve(c_maxPooledPaths);
+		s_freeBuffers.push_back(std::move(m_path));
+	}
+}
+
+// Reuses the memory of a deleted path if the pool has any
+void* Path::operator new(size_t _size)
+{
+	{
+		std::lock_guard<std::mutex> lock(s_poolMutex);
+
+		if(_size == sizeof(Path) && !s_freePaths.blocks.empty())
+		{
+			void *block = s_freePaths.blocks.back();
+			s_freePaths.blocks.pop_back();
+			return block;
+		}
+	}
+
+	return ::operator new(_size);
+}
+
+// Keeps the memory of a deleted path in the pool, unless the pool is full
+void Path::operator delete(void *_block)
+{
+	if(_block == nullptr)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(s_poolMutex);
+
+		if((int)s_freePaths.blocks.size() < c_maxPooledPaths)
+		{
+			s_freePaths.blocks.reserve(c_maxPooledPaths);
+			s_freePaths.blocks.push_back(_block);
+			return;
+		}
+	}
+
+	::operator delete(_block);
 }
 
 // Getters
@@ -29,8 +104,34 @@ bool Path::PathExists()
 		return true;
 }
 int Path::GetNumOps() { return m_numOperations; }
-int Path::GetCalcTime() { return m_pathCalcTime; }
+long long Path::GetCalcTime() { return m_pathCalcTime; }
 int Path::GetAlgoType() { return m_algoType; }
+int Path::GetStatus() { return m_status; }
+bool Path::IsPlayerPath() { return m_playerPath; }
+
+// Returns whether a tile the path still has to cross has changed since the map started watching it
+bool Path::IsInvalidated() { return m_invalidated; }
+unsigned int Path::GetMapVersion() { return m_mapVersion; }
+
+// Returns the message describing the outcome of the query, which for a path that was found is the name of the
+// algorithm that found it
+const char* Path::GetPathMessage()
+{
+	switch(m_status)
+	{
+		case PATH_FOUND: return c_algoNames[m_algoType];
+		case PATH_AT_DESTINATION: return "You are already at your destination!";
+		case PATH_INVALID_START: return "Invalid start point - please choose another!";
+		case PATH_INVALID_END: return "Invalid end point - please choose another!";
+		case PATH_UNREACHABLE: return "No path found - the end point can't be reached from the start!";
+		case PATH_NOT_FOUND: return "No path found (probably caused by broken code...)";
+	}
+
+	return "";
+}
+
+// Returns the nodes left on the path, with the next one at the back
+const std::vector<PathPoint>& Path::GetNodes() { return m_path; }
 
 // Returns the next point on the path or a default vector if there are no more points
 glm::vec2 Path::GetNextPoint()
@@ -38,7 +139,7 @@ glm::vec2 Path::GetNextPoint()
 	// If there are still points on the path return the next one...
 	if(!m_path.empty())
 	{
-		glm::vec2 tempVec = m_path.back()->GetPos();
+		glm::vec2 tempVec = m_path.back().pos;
 		m_path.pop_back();
 
 		return tempVec;
@@ -50,21 +151,14 @@ glm::vec2 Path::GetNextPoint()
 
 // Setters
 
-void Path::SetPathMessage(std::string _message) { m_pathMessage = _message; }
+void Path::SetStatus(int _status) { m_status = _status; }
 void Path::SetAlgoType(int _algoType) { m_algoType = _algoType; }
-void Path::SetPathCalcTime(int _time) {	m_pathCalcTime = _time; }
+void Path::SetPathCalcTime(long long _nanoseconds) { m_pathCalcTime = _nanoseconds; }
 void Path::SetNumOperations(int _numOps) { m_numOperations = _numOps; }
+void Path::SetMapVersion(unsigned int _version) { m_mapVersion = _version; }
 
-// Checks the next points on the path and returns true if any of them have changed
-bool Path::CheckNextPoints()
-{
-	for(int i = m_path.size() - 1; i > m_path.size() - 6 && i >= 0; i--)
-	{
-		return m_path[i]->HasChanged();
-	}
-
-	return false;
-}
+// Marks the path as crossing a tile that has changed, so the entity following it asks for a new one
+void Path::Invalidate() { m_invalidated = true; }
 
 // Smooths the path by removing any unnecessary points
 void Path::SmoothPath(glm::vec2 &_pos, glm::vec2 &_dest)
@@ -72,23 +166,23 @@ void Path::SmoothPath(glm::vec2 &_pos, glm::vec2 &_dest)
 	for(int i = m_path.size()-1; i > 1; i--)
 	{
 		int nextEle = i - 1;
-		int startXPos = m_path[i]->GetTileX();
-		int startYPos = m_path[i]->GetTileY();
+		int startXPos = m_path[i].tileX;
+		int startYPos = m_path[i].tileY;
 
 		while(true)
 		{
 			// Checks the next point in the path and if it's the last point on the path end the function call
-			if(m_path[nextEle]->GetNodeIndex() == m_path[0]->GetNodeIndex())
+			if(m_path[nextEle].nodeIndex == m_path[0].nodeIndex)
 				return;
 
-			int nextXPos = m_path[nextEle]->GetTileX();
-			int nextYPos = m_path[nextEle]->GetTileY();
+			int nextXPos = m_path[nextEle].tileX;
+			int nextYPos = m_path[nextEle].tileY;
 
 			// Checks the next point in the path and if either the x or y coordinates are the same as the point being checked remove it and check the point after it
 			// This is because a grid system is used and if either of the coordinates are the same the line is straight and the point is not required
 			// This also checks the next point to make sure it is on the same line. If it's not one the same line then we need to keep the original point otherwise
 			// the path will cut the corner
-			if((startXPos == nextXPos || startYPos == nextYPos) && (startXPos != m_path[nextEle+1]->GetTileX() && startYPos != m_path[nextEle+1]->GetTileY()))
+			if((startXPos == nextXPos || startYPos == nextYPos) && (startXPos != m_path[nextEle+1].tileX && startYPos != m_path[nextEle+1].tileY))
 			{
 				m_path.erase(m_path.begin() + nextEle);
 				nextEle--;
@@ -101,7 +195,7 @@ void Path::SmoothPath(glm::vec2 &_pos, glm::vec2 &_dest)
 	}
 
 	// If the objects start position is closer to the next waypoint than the first point on the path remove the first point in the path
-	if(glm::distance(m_path.back()->GetPos(), m_path.at(m_path.size()-2)->GetPos()) > glm::distance(_pos, m_path.at(m_path.size()-2)->GetPos()))
+	if(glm::distance(m_path.back().pos, m_path.at(m_path.size()-2).pos) > glm::distance(_pos, m_path.at(m_path.size()-2).pos))
 	{
 		m_path.pop_back();
 	}
@@ -112,22 +206,13 @@ void Path::SmoothPath(glm::vec2 &_pos, glm::vec2 &_dest)
 }
 
 // Adds a node to the back of the path
-void Path::AddNodeToBack(Node *_newPoint) { m_path.push_back(_newPoint); }
-
-// Renders the path to the screen and some information about the generated path
-void Path::DrawPath()
+void Path::AddNodeToBack(Node &_newNode)
 {
-	if(!m_path.empty())
-	{
-		for(int i = 0; i < m_path.size() - 1; i++)
-			al_draw_line(m_path.at(i)->GetPos().x, m_path.at(i)->GetPos().y, m_path.at(i+1)->GetPos().x, m_path.at(i+1)->GetPos().y, al_map_rgb(0,0,0), 2);
-	}
+	PathPoint point;
+	point.nodeIndex = _newNode.GetNodeIndex();
+	point.tileX = _newNode.GetTileX();
+	point.tileY = _newNode.GetTileY();
+	point.pos = _newNode.GetPos();
 
-	if(m_playerPath)
-	{
-		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 400, 0, "%s", m_pathMessage.c_str());
-
-		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 430, 0, "Operations to find path: %i", m_numOperations);
-		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 445, 0, "Time taken to find path: %i milliseconds", m_pathCalcTime);
-	}
+	m_path.push_back(point);
 }
\ No newline at end of file
@@ -4,9 +4,48 @@
 #include <vector>
 #include "Node.h"
 #include "glm\glm.hpp"
-#include <string>
-#include "allegro5\allegro_font.h"
 
+// Types of algorithm that can be used to generate a path
+enum AlgoType
+{
+	ALGO_A_STAR = 0,
+	ALGO_DIJKSTRA = 1,
+	ALGO_JUMP_POINT = 2,
+	ALGO_JUMP_POINT_PLUS = 3,
+	ALGO_HIERARCHICAL = 4,
+	ALGO_D_STAR_LITE = 5,
+	ALGO_BIDIRECTIONAL_A_STAR = 6,
+	ALGO_BIDIRECTIONAL_DIJKSTRA = 7
+};
+
+// Outcome of a path query. The message shown for it is worked out when it is asked for, so a path doesn't have
+// to store one
+enum PathStatus
+{
+	PATH_NOT_SEARCHED = 0,
+	PATH_FOUND = 1,
+	PATH_AT_DESTINATION = 2,
+	PATH_INVALID_START = 3,
+	PATH_INVALID_END = 4,
+	PATH_UNREACHABLE = 5,
+	PATH_NOT_FOUND = 6
+};
+
+// Number of deleted path objects and waypoint buffers kept to be reused by the next paths created
+const int c_maxPooledPaths = 64;
+
+// A tile on a path. Paths keep copies of the details they need rather than pointers to the nodes, as the
+// nodes of a chunk are deleted when it is unloaded
+struct PathPoint
+{
+	int nodeIndex;
+	int tileX, tileY;
+	glm::vec2 pos;
+};
+
+// The result of a path query. Paths are created and deleted for every request, so the memory for the object and
+// for its waypoints is taken from a pool of deleted paths, and once the pool has filled up creating a path
+// doesn't allocate anything. Paths can be created and deleted on any thread
 class Path
 {
 	public:
@@ -14,36 +53,45 @@ class Path
 		Path(bool _playerPath);
 		~Path();
 
+		static void* operator new(size_t _size);
+		static void operator delete(void *_block);
+
 		// Getters
 		bool PathExists();
 		int GetNumOps();
-		int GetCalcTime();
+		long long GetCalcTime();
 		int GetAlgoType();
+		int GetStatus();
+		bool IsPlayerPath();
+		bool IsInvalidated();
+		unsigned int GetMapVersion();
+		const char* GetPathMessage();
+		const std::vector<PathPoint>& GetNodes();
 		glm::vec2 GetNextPoint();		
 
 		// Setters
-		void SetPathMessage(std::string _message);
+		void SetStatus(int _status);
 		void SetAlgoType(int _algoType);
-		void SetPathCalcTime(int _time);
+		void SetPathCalcTime(long long _nanoseconds);
 		void SetNumOperations(int _numOps);
+		void SetMapVersion(unsigned int _version);
+		void Invalidate();
 
-		bool CheckNextPoints();
 		void SmoothPath(glm::vec2 &_pos, glm::vec2 &_dest);
-		void AddNodeToBack(Node *_newNode);
-		void DrawPath();
+		void AddNodeToBack(Node &_newNode);
 
 	private:
 		bool m_playerPath;
+		bool m_invalidated;
 
+		int m_status;
 		int m_numOperations;
-		int m_pathCalcTime;
+		long long m_pathCalcTime;
 		int m_algoType;
 
-		std::vector<Node*> m_path;
-
-		std::string m_pathMessage;
+		unsigned int m_mapVersion;
 
-		ALLEGRO_FONT *m_font;
+		std::vector<PathPoint> m_path;
 };
 
 #endif
\ No newline at end of file
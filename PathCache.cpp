@@ -0,0 +1,224 @@
+#include "PathCache.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Constructor - initialises member variables
+PathCache::PathCache(int _numXTiles, int _numYTiles)
+{
+	m_enabled = true;
+	m_numXTiles = _numXTiles;
+	m_numYTiles = _numYTiles;
+	m_numXRegions = (_numXTiles + c_cacheRegionSize - 1) / c_cacheRegionSize;
+	m_numYRegions = (_numYTiles + c_cacheRegionSize - 1) / c_cacheRegionSize;
+
+	m_numHits = 0;
+	m_numMisses = 0;
+	m_numEvictions = 0;
+	m_numInvalidations = 0;
+
+	m_regionEntries.resize(m_numXRegions * m_numYRegions);
+}
+
+// Destructor
+PathCache::~PathCache() {}
+
+// Getters
+
+int PathCache::GetNumHits() { return m_numHits; }
+int PathCache::GetNumMisses() { return m_numMisses; }
+int PathCache::GetNumEvictions() { return m_numEvictions; }
+int PathCache::GetNumInvalidations() { return m_numInvalidations; }
+
+// Returns the fraction of lookups that found a path in the cache
+float PathCache::GetHitRate()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_numHits + m_numMisses == 0)
+		return 0.0f;
+
+	return (float)m_numHits / (m_numHits + m_numMisses);
+}
+
+// Setters
+
+// Turns the cache on or off. Turning it off clears it and stops paths being looked up or added
+void PathCache::SetEnabled(bool _enabled)
+{
+	if(!_enabled)
+		Clear();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_enabled = _enabled;
+}
+
+// Looks for a cached path for the query and copies its tiles if there is one. Paths found before the given
+// version are out of date and are removed instead. Returns whether a path was found
+bool PathCache::FindPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, unsigned int _minVersion, std::vector<int> &_tiles)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(!m_enabled)
+		return false;
+
+	auto found = m_lookup.find(MakeKey(_startIndex, _endIndex, _algoType, _isPlayer));
+
+	if(found == m_lookup.end())
+	{
+		m_numMisses++;
+		return false;
+	}
+
+	if(found->second->mapVersion < _minVersion)
+	{
+		RemoveEntry(found->second);
+		m_numInvalidations++;
+		m_numMisses++;
+		return false;
+	}
+
+	// Moves the entry to the front so it is the last to be evicted
+	m_entries.splice(m_entries.begin(), m_entries, found->second);
+
+	_tiles = found->second->tiles;
+
+	m_numHits++;
+
+	return true;
+}
+
+// Adds a path to the cache, evicting the least recently used path if the cache is full, and records it in
+// the list of every region it passes through
+void PathCache::AddPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, unsigned int _mapVersion, const std::vector<int> &_tiles)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(!m_enabled)
+		return;
+
+	unsigned long long key = MakeKey(_startIndex, _endIndex, _algoType, _isPlayer);
+	auto found = m_lookup.find(key);
+
+	if(found != m_lookup.end())
+		RemoveEntry(found->second);
+
+	if((int)m_entries.size() >= c_pathCacheSize)
+	{
+		RemoveEntry(--m_entries.end());
+		m_numEvictions++;
+	}
+
+	PathCacheEntry entry;
+	entry.key = key;
+	entry.mapVersion = _mapVersion;
+	entry.tiles = _tiles;
+
+	// A change next to a tile also changes the cost of moving onto it, so each tile is recorded in the
+	// regions its neighbours are in as well
+	for(int tile : _tiles)
+	{
+		int tileX = tile % m_numXTiles;
+		int tileY = tile / m_numXTiles;
+
+		for(int y = std::max(tileY - 1, 0) / c_cacheRegionSize; y <= std::min(tileY + 1, m_numYTiles - 1) / c_cacheRegionSize; y++)
+		{
+			for(int x = std::max(tileX - 1, 0) / c_cacheRegionSize; x <= std::min(tileX + 1, m_numXTiles - 1) / c_cacheRegionSize; x++)
+			{
+				int region = y * m_numXRegions + x;
+
+				if(std::find(entry.regions.begin(), entry.regions.end(), region) == entry.regions.end())
+					entry.regions.push_back(region);
+			}
+		}
+	}
+
+	for(int region : entry.regions)
+		m_regionEntries[region].push_back(key);
+
+	m_entries.push_front(entry);
+	m_lookup[key] = m_entries.begin();
+}
+
+// Removes every cached path that passes on or next to the given tile, or only the player's paths if the change
+// only affects the player's costs
+void PathCache::InvalidateTile(int _nodeIndex, bool _playerPathsOnly)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	int tileX = _nodeIndex % m_numXTiles;
+	int tileY = _nodeIndex / m_numXTiles;
+
+	std::vector<unsigned long long> &regionEntries = m_regionEntries[(tileY / c_cacheRegionSize) * m_numXRegions + tileX / c_cacheRegionSize];
+
+	for(unsigned int i = 0; i < regionEntries.size();)
+	{
+		std::list<PathCacheEntry>::iterator entry = m_lookup[regionEntries[i]];
+
+		// The lowest bit of the key is set for the player's paths
+		if((!_playerPathsOnly || (entry->key & 1)) && PassesNear(*entry, tileX, tileY))
+		{
+			// Removing the entry also removes it from this region's list, so the same position is checked again
+			RemoveEntry(entry);
+			m_numInvalidations++;
+		}
+
+		else
+			i++;
+	}
+}
+
+// Removes every path from the cache
+void PathCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_numInvalidations += m_entries.size();
+
+	m_entries.clear();
+	m_lookup.clear();
+
+	for(std::vector<unsigned long long> &regionEntries : m_regionEntries)
+		regionEntries.clear();
+}
+
+// Combines the parts of a query into a single key
+unsigned long long PathCache::MakeKey(int _startIndex, int _endIndex, int _algoType, bool _isPlayer)
+{
+	unsigned long long numNodes = m_numXTiles * m_numYTiles;
+
+	return (((unsigned long long)_startIndex * numNodes + _endIndex) * 16 + _algoType) * 2 + (_isPlayer ? 1 : 0);
+}
+
+// Returns whether any tile of the path is on or next to the given tile
+bool PathCache::PassesNear(PathCacheEntry &_entry, int _tileX, int _tileY)
+{
+	for(int tile : _entry.tiles)
+	{
+		if(abs(tile % m_numXTiles - _tileX) <= 1 && abs(tile / m_numXTiles - _tileY) <= 1)
+			return true;
+	}
+
+	return false;
+}
+
+// Removes an entry from the cache and from the list of every region it passes through
+void PathCache::RemoveEntry(std::list<PathCacheEntry>::iterator _entry)
+{
+	for(int region : _entry->regions)
+	{
+		std::vector<unsigned long long> &regionEntries = m_regionEntries[region];
+
+		for(unsigned int i = 0; i < regionEntries.size(); i++)
+		{
+			if(regionEntries[i] == _entry->key)
+			{
+				regionEntries[i] = regionEntries.back();
+				regionEntries.pop_back();
+				break;
+			}
+		}
+	}
+
+	m_lookup.erase(_entry->key);
+	m_entries.erase(_entry);
+}
\ No newline at end of file
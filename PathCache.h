@@ -0,0 +1,74 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+// Maximum number of paths kept in the cache before the least recently used one is evicted
+const int c_pathCacheSize = 256;
+
+// Size in tiles of each side of the regions the cache uses to find the paths near a changed tile
+const int c_cacheRegionSize = 8;
+
+// A path found by an earlier query. The tiles are stored from the end of the path back to the start
+struct PathCacheEntry
+{
+	unsigned long long key;
+	unsigned int mapVersion;
+	std::vector<int> tiles;
+	std::vector<int> regions;
+};
+
+// Bounded least recently used cache of path results keyed on the start tile, end tile, algorithm and type of
+// entity. Each region of the map keeps a list of the cached paths passing through it, so when a tile changes
+// only the paths in the regions around it are checked, and only those that pass on or next to the tile are
+// removed. Entries are also stamped with the map version they were found at so that changes the map can't
+// report tile by tile throw them all out. The cache is locked so paths can be looked up from worker threads
+class PathCache
+{
+	public:
+		// Constructor and destructor
+		PathCache(int _numXTiles, int _numYTiles);
+		~PathCache();
+
+		// Getters
+		int GetNumHits();
+		int GetNumMisses();
+		int GetNumEvictions();
+		int GetNumInvalidations();
+		float GetHitRate();
+
+		// Setters
+		void SetEnabled(bool _enabled);
+
+		bool FindPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, unsigned int _minVersion, std::vector<int> &_tiles);
+		void AddPath(int _startIndex, int _endIndex, int _algoType, bool _isPlayer, unsigned int _mapVersion, const std::vector<int> &_tiles);
+
+		void InvalidateTile(int _nodeIndex, bool _playerPathsOnly = false);
+		void Clear();
+
+	private:
+		unsigned long long MakeKey(int _startIndex, int _endIndex, int _algoType, bool _isPlayer);
+		bool PassesNear(PathCacheEntry &_entry, int _tileX, int _tileY);
+		void RemoveEntry(std::list<PathCacheEntry>::iterator _entry);
+
+		bool m_enabled;
+
+		int m_numXTiles, m_numYTiles;
+		int m_numXRegions, m_numYRegions;
+
+		int m_numHits;
+		int m_numMisses;
+		int m_numEvictions;
+		int m_numInvalidations;
+
+		std::list<PathCacheEntry> m_entries;
+		std::unordered_map<unsigned long long, std::list<PathCacheEntry>::iterator> m_lookup;
+		std::vector<std::vector<unsigned long long>> m_regionEntries;
+
+		std::mutex m_mutex;
+};
+
+#endif
\ No newline at end of file
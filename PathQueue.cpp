@@ -0,0 +1,228 @@
+#include "PathQueue.h"
+#include "PathSearch.h"
+#include "Map.h"
+
+// Constructor - initialises member variables and starts the worker threads
+PathQueue::PathQueue(Map *_map, int _numWorkers)
+{
+	m_map = _map;
+	m_stopping = false;
+	m_nextTicket = 0;
+
+	if(_numWorkers < 1)
+		_numWorkers = 1;
+
+	for(int i = 0; i < _numWorkers; i++)
+		m_threads.push_back(std::thread(&PathQueue::WorkerLoop, this));
+}
+
+// Destructor - stops the workers once their current slice is done and deletes every path that was never collected
+PathQueue::~PathQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_requestCondition.notify_all();
+
+	for(std::thread &thread : m_threads)
+		thread.join();
+
+	for(QueuedPathRequest &request : m_pending)
+		delete request.path;
+
+	for(auto &finished : m_finished)
+		delete finished.second;
+}
+
+// Getters
+
+int PathQueue::GetNumWorkers() { return m_threads.size(); }
+
+// Adds a request to the back of the queue and returns the ticket its path is collected with
+int PathQueue::Submit(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, DStarLite *_planner)
+{
+	QueuedPathRequest request;
+	request.startPos = _startPos;
+	request.endPos = _endPos;
+	request.algoType = _algoType;
+	request.isPlayer = _isPlayer;
+	request.planner = _planner;
+	request.path = new Path(_isPlayer);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		request.ticket = m_nextTicket++;
+		m_pending.push_back(request);
+	}
+
+	m_requestCondition.notify_one();
+
+	return request.ticket;
+}
+
+// Returns the path for the given ticket if its search has finished, handing it over to the caller to delete, or
+// nullptr if it is still waiting or running
+Path* PathQueue::Collect(int _ticket)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto found = m_finished.find(_ticket);
+
+	if(found == m_finished.end())
+		return nullptr;
+
+	Path *path = found->second;
+	m_finished.erase(found);
+
+	return path;
+}
+
+// Throws away the request for the given ticket. A waiting request is removed from the queue, and a running one is
+// stopped by its worker before the next slice. This never waits for the worker
+void PathQueue::Cancel(int _ticket)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for(auto request = m_pending.begin(); request != m_pending.end(); request++)
+	{
+		if(request->ticket == _ticket)
+		{
+			delete request->path;
+			m_pending.erase(request);
+			return;
+		}
+	}
+
+	if(m_running.count(_ticket) != 0)
+	{
+		m_cancelled.insert(_ticket);
+		return;
+	}
+
+	auto found = m_finished.find(_ticket);
+
+	if(found != m_finished.end())
+	{
+		delete found->second;
+		m_finished.erase(found);
+	}
+}
+
+// Cancels every request that uses the given planner and waits until no worker is using it, so that it can be
+// deleted. Only the search using the planner is waited for
+void PathQueue::ReleasePlanner(DStarLite *_planner)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for(auto request = m_pending.begin(); request != m_pending.end();)
+	{
+		if(request->planner == _planner)
+		{
+			delete request->path;
+			request = m_pending.erase(request);
+		}
+
+		else
+			request++;
+	}
+
+	for(auto &running : m_running)
+	{
+		if(running.second == _planner)
+			m_cancelled.insert(running.first);
+	}
+
+	m_doneCondition.wait(lock, [this, _planner] { return !PlannerInUse(_planner); });
+}
+
+// Takes the first request in the queue whose planner isn't already being used by another worker and marks it as
+// running. Must be called with the queue locked. Returns false if there is no such request
+bool PathQueue::PopRequest(QueuedPathRequest &_request)
+{
+	for(auto request = m_pending.begin(); request != m_pending.end(); request++)
+	{
+		if(request->planner == nullptr || !PlannerInUse(request->planner))
+		{
+			_request = *request;
+			m_pending.erase(request);
+			m_running[_request.ticket] = _request.planner;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Returns whether a running request is using the given planner. Must be called with the queue locked
+bool PathQueue::PlannerInUse(DStarLite *_planner)
+{
+	for(auto &running : m_running)
+	{
+		if(running.second == _planner)
+			return true;
+	}
+
+	return false;
+}
+
+// Returns whether the running request for the given ticket should stop
+bool PathQueue::IsCancelled(int _ticket)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_stopping || m_cancelled.count(_ticket) != 0;
+}
+
+// Main loop of each worker thread. Waits for a request, then searches for its path a slice at a time, locking the
+// map for reading only while each slice runs and checking between slices whether the request was cancelled. Each
+// worker keeps its own search so the buffers it writes to are reused from one request to the next
+void PathQueue::WorkerLoop()
+{
+	PathSearch search(m_map);
+
+	while(true)
+	{
+		QueuedPathRequest request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			while(!m_stopping && !PopRequest(request))
+				m_requestCondition.wait(lock);
+
+			if(m_stopping)
+				return;
+		}
+
+		bool finished;
+
+		{
+			std::shared_lock<std::shared_timed_mutex> mapLock = m_map->LockForSearch();
+			search.Start(request.path, request.startPos, request.endPos, request.algoType, request.isPlayer, OPEN_LIST_BINARY_HEAP, request.planner);
+			finished = search.Step(c_pathSliceExpansions);
+		}
+
+		while(!finished && !IsCancelled(request.ticket))
+		{
+			std::shared_lock<std::shared_timed_mutex> mapLock = m_map->LockForSearch();
+			finished = search.Step(c_pathSliceExpansions);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			m_running.erase(request.ticket);
+
+			if(m_cancelled.erase(request.ticket) != 0 || !finished)
+				search.Cancel();
+			else
+				m_finished[request.ticket] = search.TakePath();
+		}
+
+		// The request may have been holding up others that use the same planner, or a thread releasing the planner
+		m_requestCondition.notify_all();
+		m_doneCondition.notify_all();
+	}
+}
\ No newline at end of file
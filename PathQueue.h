@@ -0,0 +1,80 @@
+#ifndef PATHQUEUE_H
+#define PATHQUEUE_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "glm\glm.hpp"
+#include "Path.h"
+
+class Map;
+class DStarLite;
+
+// Ticket returned when there is no request to wait on
+const int c_noPathTicket = -1;
+
+// Number of nodes a worker expands each time it locks the map. The map can only be changed between these
+// slices, so this is the most a change has to wait for a running search
+const int c_pathSliceExpansions = 2000;
+
+// A path requested from the queue, waiting for a worker. The path object is created when the request is made
+// and filled in by the worker
+struct QueuedPathRequest
+{
+	int ticket;
+	glm::vec2 startPos;
+	glm::vec2 endPos;
+	int algoType;
+	bool isPlayer;
+	DStarLite *planner;
+	Path *path;
+};
+
+// Queue of path requests searched by a set of background worker threads, so the thread that asks for a path
+// never waits for it. Each request is given a ticket that the finished path is collected with later, and a
+// request that is no longer wanted can be cancelled with its ticket whether it is waiting, running or finished.
+// Workers search a slice at a time with the map locked for reading, so the map can be changed while searches
+// run. Requests that share a D* Lite planner are run one after another, as the planner keeps the search state
+class PathQueue
+{
+	public:
+		// Constructor and destructor
+		PathQueue(Map *_map, int _numWorkers);
+		~PathQueue();
+
+		// Getters
+		int GetNumWorkers();
+
+		int Submit(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, DStarLite *_planner);
+		Path* Collect(int _ticket);
+		void Cancel(int _ticket);
+		void ReleasePlanner(DStarLite *_planner);
+
+	private:
+		bool PopRequest(QueuedPathRequest &_request);
+		bool PlannerInUse(DStarLite *_planner);
+		bool IsCancelled(int _ticket);
+		void WorkerLoop();
+
+		bool m_stopping;
+		int m_nextTicket;
+
+		std::deque<QueuedPathRequest> m_pending;
+		std::unordered_map<int, DStarLite*> m_running;
+		std::unordered_set<int> m_cancelled;
+		std::unordered_map<int, Path*> m_finished;
+
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_mutex;
+		std::condition_variable m_requestCondition;
+		std::condition_variable m_doneCondition;
+
+		Map *m_map;
+};
+
+#endif
\ No newline at end of file
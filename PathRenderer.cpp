@@ -0,0 +1,27 @@
+#include "PathRenderer.h"
+
+// Constructor - loads the font used for the path details
+PathRenderer::PathRenderer() { m_font = al_load_font("Arial.ttf", 14, 0); }
+
+// Destructor - frees up necessary objects to prevent memory leaks
+PathRenderer::~PathRenderer() { al_destroy_font(m_font); }
+
+// Renders the path to the screen and some information about the generated path
+void PathRenderer::DrawPath(Path *_path)
+{
+	if(_path == nullptr)
+		return;
+
+	const std::vector<PathPoint> &nodes = _path->GetNodes();
+
+	for(unsigned int i = 0; i + 1 < nodes.size(); i++)
+		al_draw_line(nodes.at(i).pos.x, nodes.at(i).pos.y, nodes.at(i+1).pos.x, nodes.at(i+1).pos.y, al_map_rgb(0,0,0), 2);
+
+	if(_path->IsPlayerPath())
+	{
+		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 445, 0, "%s", _path->GetPathMessage());
+
+		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 475, 0, "Operations to find path: %i", _path->GetNumOps());
+		al_draw_textf(m_font, al_map_rgb(0,0,0), 1020, 490, 0, "Time taken to find path: %.3f milliseconds", _path->GetCalcTime() / 1000000.0);
+	}
+}
\ No newline at end of file
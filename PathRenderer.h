@@ -0,0 +1,23 @@
+#ifndef PATHRENDERER_H
+#define PATHRENDERER_H
+
+#include <allegro5\allegro_primitives.h>
+#include <allegro5\allegro_font.h>
+#include "Path.h"
+
+// Draws paths with Allegro, along with the details of how the player's path was found. One renderer is
+// shared by every path, so the font is only loaded once
+class PathRenderer
+{
+	public:
+		// Constructor and destructor
+		PathRenderer();
+		~PathRenderer();
+
+		void DrawPath(Path *_path);
+
+	private:
+		ALLEGRO_FONT *m_font;
+};
+
+#endif
\ No newline at end of file
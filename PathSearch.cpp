@@ -0,0 +1,176 @@
+#include "PathSearch.h"
+#include "Map.h"
+#include <chrono>
+
+// Constructor - initialises member variables
+PathSearch::PathSearch(Map *_map)
+{
+	m_map = _map;
+	m_path = nullptr;
+	m_planner = nullptr;
+	m_finished = true;
+	m_bestFirst = false;
+	m_isPlayer = false;
+	m_diagsAllowed = false;
+	m_requestedAlgoType = ALGO_A_STAR;
+	m_algoType = ALGO_A_STAR;
+	m_openListType = OPEN_LIST_BINARY_HEAP;
+	m_startIndex = -1;
+	m_endIndex = -1;
+	m_numOps = 0;
+	m_calcTime = 0;
+	m_startVersion = 0;
+}
+
+// Destructor - deletes the path if it was never taken
+PathSearch::~PathSearch()
+{
+	if(m_path != nullptr)
+		delete m_path;
+}
+
+// Getters
+
+// Returns whether a search has been started whose path hasn't been taken yet
+bool PathSearch::IsRunning() { return m_path != nullptr; }
+
+// Starts a new query, replacing any search that is still running. Simple queries such as ones to an invalid
+// point or ones found in the path cache are finished straight away, and the first step returns the path
+void PathSearch::Start(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner)
+{
+	Start(new Path(_isPlayer), _startPos, _endPos, _algoType, _isPlayer, _openListType, _planner);
+}
+
+// Starts a new query that fills in the given path object, which the search takes over
+void PathSearch::Start(Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType, DStarLite *_planner)
+{
+	if(m_path != nullptr)
+		delete m_path;
+
+	m_path = _path;
+
+	m_startPos = _startPos;
+	m_endPos = _endPos;
+	m_requestedAlgoType = _algoType;
+	m_isPlayer = _isPlayer;
+	m_openListType = _openListType;
+	m_planner = _planner;
+	m_numOps = 0;
+	m_calcTime = 0;
+
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+
+	Begin();
+
+	m_calcTime += chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now() - start).count();
+}
+
+// Expands up to the given number of nodes and returns whether the search has finished. Once it has, the path
+// is ready to be taken
+bool PathSearch::Step(int _maxExpansions)
+{
+	if(m_path == nullptr)
+		return false;
+
+	if(m_finished)
+		return true;
+
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+
+	// The version of the search that was started depends on whether diagonal moves are allowed, so if that has
+	// changed the search starts again
+	if(m_diagsAllowed != m_map->DiagsAllowed())
+		Begin();
+
+	if(!m_finished)
+	{
+		int status;
+
+		if(m_bestFirst)
+			status = m_map->ContinueBestFirstSearch(m_context, m_context.GetOpenList(m_openListType), m_endIndex, m_algoType, m_isPlayer, _maxExpansions, m_numOps);
+		else
+			status = m_map->SearchPath(m_context, m_openListType, m_startIndex, m_endIndex, m_algoType, m_isPlayer, m_planner, m_numOps) ? SEARCH_FOUND : SEARCH_FAILED;
+
+		bool mapChanged = m_map->GetCostVersion(m_isPlayer) != m_startVersion;
+
+		// Tiles changed since the search started may have cut the path that was found or opened up one that
+		// wasn't, so in either case the search is run again against the map as it is now
+		if(mapChanged && (status == SEARCH_FAILED || (status == SEARCH_FOUND && !PathStillTraversable())))
+			Begin();
+
+		else if(status != SEARCH_RUNNING)
+		{
+			m_map->FinishQuery(m_context, m_path, m_startIndex, m_endIndex, m_algoType, m_isPlayer, status == SEARCH_FOUND, false, !mapChanged, m_tiles);
+			m_finished = true;
+		}
+	}
+
+	m_calcTime += chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now() - start).count();
+
+	if(m_finished)
+	{
+		m_path->SetPathCalcTime(m_calcTime);
+		m_path->SetNumOperations(m_numOps);
+	}
+
+	return m_finished;
+}
+
+// Hands the finished path over to the caller, who is then responsible for deleting it
+Path* PathSearch::TakePath()
+{
+	Path *path = m_path;
+	m_path = nullptr;
+
+	return path;
+}
+
+// Stops the running search and throws away its path
+void PathSearch::Cancel()
+{
+	if(m_path != nullptr)
+		delete m_path;
+
+	m_path = nullptr;
+	m_finished = true;
+}
+
+// Checks the query and prepares the context for the search, or finishes the query straight away if it is
+// invalid or its path is in the cache
+void PathSearch::Begin()
+{
+	m_algoType = m_requestedAlgoType;
+	m_startVersion = m_map->GetCostVersion(m_isPlayer);
+	m_diagsAllowed = m_map->DiagsAllowed();
+	m_tiles.clear();
+
+	m_finished = !m_map->BeginQuery(m_context, m_path, m_startPos, m_endPos, m_algoType, m_planner, m_startIndex, m_endIndex);
+
+	if(m_finished)
+		return;
+
+	if(m_map->FindCachedPath(m_startIndex, m_endIndex, m_algoType, m_isPlayer, m_tiles))
+	{
+		m_map->FinishQuery(m_context, m_path, m_startIndex, m_endIndex, m_algoType, m_isPlayer, true, true, false, m_tiles);
+		m_finished = true;
+		return;
+	}
+
+	m_bestFirst = m_algoType == ALGO_A_STAR || m_algoType == ALGO_DIJKSTRA;
+
+	if(m_bestFirst)
+		m_map->StartBestFirstSearch(m_context, m_context.GetOpenList(m_openListType), m_startIndex, m_endIndex, m_algoType);
+}
+
+// Returns whether every node on the path found can still be crossed, by following the parents on the context
+// from the end node back to the start
+bool PathSearch::PathStillTraversable()
+{
+	for(int nodeIndex = m_endIndex; nodeIndex != -1; nodeIndex = m_context.GetParent(nodeIndex))
+	{
+		if(!m_map->GetNode(nodeIndex).IsTraversable())
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
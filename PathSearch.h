@@ -0,0 +1,65 @@
+#ifndef PATHSEARCH_H
+#define PATHSEARCH_H
+
+#include <vector>
+#include "glm\glm.hpp"
+#include "SearchContext.h"
+#include "Path.h"
+
+class Map;
+class DStarLite;
+
+// A path query that can be run a few node expansions at a time, so a long search can be spread over several
+// frames, or over several short locks of the map by a background worker, instead of holding either up. The search keeps its own context, which holds everything it has
+// found so far between steps, and reusing the same object for the next query reuses the context's buffers.
+// A Star and Dijkstra's algorithm are stopped and carried on between steps. The other algorithms can't be
+// paused, so they run in full on the first step. If the map changes while a search is running the path found
+// is not cached, and the search starts again if the path runs through a tile that can no longer be crossed
+class PathSearch
+{
+	public:
+		// Constructor and destructor
+		PathSearch(Map *_map);
+		~PathSearch();
+
+		// Getters
+		bool IsRunning();
+
+		void Start(glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType = OPEN_LIST_BINARY_HEAP, DStarLite *_planner = NULL);
+		void Start(Path *_path, glm::vec2 _startPos, glm::vec2 _endPos, int _algoType, bool _isPlayer, int _openListType = OPEN_LIST_BINARY_HEAP, DStarLite *_planner = NULL);
+		bool Step(int _maxExpansions);
+		Path* TakePath();
+		void Cancel();
+
+	private:
+		void Begin();
+		bool PathStillTraversable();
+
+		bool m_finished;
+		bool m_bestFirst;
+		bool m_isPlayer;
+		bool m_diagsAllowed;
+
+		int m_requestedAlgoType;
+		int m_algoType;
+		int m_openListType;
+		int m_startIndex;
+		int m_endIndex;
+		int m_numOps;
+
+		long long m_calcTime;
+		unsigned int m_startVersion;
+
+		glm::vec2 m_startPos;
+		glm::vec2 m_endPos;
+
+		std::vector<int> m_tiles;
+
+		SearchContext m_context;
+
+		Path *m_path;
+		Map *m_map;
+		DStarLite *m_planner;
+};
+
+#endif
\ No newline at end of file
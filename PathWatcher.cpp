@@ -0,0 +1,99 @@
+#include "PathWatcher.h"
+#include "Path.h"
+
+// Constructor
+PathWatcher::PathWatcher() {}
+
+// Destructor
+PathWatcher::~PathWatcher() {}
+
+// Getters
+
+// Returns the number of paths being watched
+int PathWatcher::GetNumWatched() { return m_pathTiles.size(); }
+
+// Starts watching every tile of the path. The tiles are remembered so the path can be taken out of the index
+// after points have been taken off it
+void PathWatcher::Watch(Path *_path)
+{
+	if(m_pathTiles.count(_path) > 0)
+		return;
+
+	const std::vector<PathPoint> &points = _path->GetNodes();
+	std::vector<int> &tiles = m_pathTiles[_path];
+
+	tiles.reserve(points.size());
+
+	for(unsigned int i = 0; i < points.size(); i++)
+	{
+		WatchedPoint point;
+		point.path = _path;
+		point.pointIndex = i;
+
+		m_tilePoints[points[i].nodeIndex].push_back(point);
+		tiles.push_back(points[i].nodeIndex);
+	}
+}
+
+// Stops watching the path. This must be done before the path is deleted
+void PathWatcher::Unwatch(Path *_path)
+{
+	auto found = m_pathTiles.find(_path);
+
+	if(found == m_pathTiles.end())
+		return;
+
+	for(int tile : found->second)
+	{
+		auto tilePoints = m_tilePoints.find(tile);
+
+		if(tilePoints == m_tilePoints.end())
+			continue;
+
+		std::vector<WatchedPoint> &points = tilePoints->second;
+
+		for(unsigned int i = 0; i < points.size();)
+		{
+			if(points[i].path == _path)
+			{
+				points[i] = points.back();
+				points.pop_back();
+			}
+
+			else
+				i++;
+		}
+
+		if(points.empty())
+			m_tilePoints.erase(tilePoints);
+	}
+
+	m_pathTiles.erase(found);
+}
+
+// Invalidates the paths that cross the changed tile, or only the player's paths if the change only affects
+// the player's costs. Points are taken off the back of a path as it is followed, so a point is still ahead if
+// its index is inside the path. The last point taken off is the one the entity is heading to, so it counts too
+void PathWatcher::TileChanged(int _nodeIndex, bool _playerPathsOnly)
+{
+	auto found = m_tilePoints.find(_nodeIndex);
+
+	if(found == m_tilePoints.end())
+		return;
+
+	for(WatchedPoint &point : found->second)
+	{
+		if(_playerPathsOnly && !point.path->IsPlayerPath())
+			continue;
+
+		if(point.pointIndex <= (int)point.path->GetNodes().size())
+			point.path->Invalidate();
+	}
+}
+
+// Invalidates every watched path, for changes that can affect any move on the map
+void PathWatcher::InvalidateAll()
+{
+	for(auto &watched : m_pathTiles)
+		watched.first->Invalidate();
+}
\ No newline at end of file
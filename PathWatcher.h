@@ -0,0 +1,41 @@
+#ifndef PATHWATCHER_H
+#define PATHWATCHER_H
+
+#include <vector>
+#include <unordered_map>
+
+class Path;
+
+// A point on a watched path, given by its position in the path's list of nodes
+struct WatchedPoint
+{
+	Path *path;
+	int pointIndex;
+};
+
+// Reverse index from each tile to the paths entities are following through it. When a tile changes the map
+// tells the watcher, which marks just the paths that still have the tile ahead of them as invalidated, so the
+// work done is proportional to the number of changes rather than to the number of entities checking their
+// paths. Paths are watched and tiles changed from the thread that edits the map
+class PathWatcher
+{
+	public:
+		// Constructor and destructor
+		PathWatcher();
+		~PathWatcher();
+
+		// Getters
+		int GetNumWatched();
+
+		void Watch(Path *_path);
+		void Unwatch(Path *_path);
+
+		void TileChanged(int _nodeIndex, bool _playerPathsOnly);
+		void InvalidateAll();
+
+	private:
+		std::unordered_map<int, std::vector<WatchedPoint>> m_tilePoints;
+		std::unordered_map<Path*, std::vector<int>> m_pathTiles;
+};
+
+#endif
\ No newline at end of file
@@ -1,27 +1,16 @@
 #include "Player.h"
-#include "allegro5\allegro_primitives.h"
 
 // Constructor - initialises member variables
 Player::Player(Map *_map)
 {
 	m_hasDestination = false;
-	m_sprite = al_load_bitmap("Stickman.png");
-	m_goalSprite = al_load_bitmap("Goal.png");
-	m_spriteWidth = al_get_bitmap_width(m_sprite);
-	m_spriteHeight = al_get_bitmap_height(m_sprite);
 	m_pos = glm::vec2(200,100);
 	m_map = _map;
 	m_isPlayer = true;
 }
 
 // Destructor - cleans up all necessary objects to prevent memory leaks
-Player::~Player()
-{
-	al_destroy_bitmap(m_sprite);
-	al_destroy_bitmap(m_goalSprite);
-	if(m_path != nullptr)
-		delete m_path;	
-}
+Player::~Player() {}
 
 // Getters
 
@@ -36,11 +25,11 @@ void Player::SetDestination(glm::vec2 _dest)
 	m_destination = _dest;
 	m_hasDestination = true;
 
-	// If the player already has a path when the destination changes
-	// the previous path is deleted and a new path is requested
-	if(m_hasPath)
+	// If the player already has a path, or is still waiting for one to the old destination, when the
+	// destination changes the previous path and request are thrown away and a new path is requested
+	if(m_hasPath || IsSearching())
 	{
-		int tempAlgo = m_path->GetAlgoType();
+		int tempAlgo = m_hasPath ? m_path->GetAlgoType() : m_requestAlgo;
 		ClearPath();
 		RequestPath(tempAlgo);
 	}
@@ -59,28 +48,14 @@ void Player::TimedUpdate()
 {
 	if(m_hasPath)
 	{
-		// This checks the next few points in the path to see if they have changed. This is more efficient that generating
-		// a new path every second but only checks if the path has changed and doesn't take into account if other terrain has
-		// changed which might provide a better path.
-		if(m_path->CheckNextPoints())
-		{
-			int tempAlgo = m_path->GetAlgoType();
-			ClearPath();
-			RequestPath(tempAlgo);
-		}
-	}
-}
-
-// Renders the player and its destination and path (if it has one) to the screen
-void Player::Render()
-{
-	al_draw_bitmap(m_sprite, m_pos.x - m_spriteWidth / 2, m_pos.y - m_spriteHeight / 2, 0);
-
-	if(m_hasDestination == true)
-	{
-		al_draw_bitmap(m_goalSprite, m_destination.x - m_spriteWidth / 2, m_destination.y - m_spriteHeight / 2, 0);
+		// D* Lite paths are repaired whenever anything on the map has changed, which also finds better paths opened up by
+		// the changes, and only costs as much as the part of the search the changes affect
+		if(m_path->GetAlgoType() == ALGO_D_STAR_LITE)
+			RepairPath();
+
+		// The map invalidates the path when a tile anywhere on the rest of it changes, so a new path is only requested when
+		// this one is affected. This doesn't take into account if other terrain has changed which might provide a better path.
+		else if(!IsSearching() && m_path->IsInvalidated())
+			RequestPath(m_path->GetAlgoType());
 	}
-
-	if(m_path != nullptr)
-		m_path->DrawPath();
 }
\ No newline at end of file
@@ -19,12 +19,9 @@ class Player : public BaseEntity
 		// Functions to be defined by this class
 		virtual void Update();
 		virtual void TimedUpdate();
-		virtual void Render();
 
 	private:
 		bool m_hasDestination;
-
-		ALLEGRO_BITMAP *m_goalSprite;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "SearchContext.h"
+#include <algorithm>
+
+// Constructor - initialises member variables
+SearchContext::SearchContext()
+{
+	m_searchGeneration = 0;
+}
+
+// Destructor
+SearchContext::~SearchContext() {}
+
+// Getters
+
+// Returns the search state of the given node. A node whose generation does not match the current search
+// has not been visited by it, so no per-node data has to be cleared between searches
+int SearchContext::GetSearchState(int _nodeIndex)
+{
+	if(m_generations[_nodeIndex] != m_searchGeneration)
+		return NODE_UNVISITED;
+
+	return m_states[_nodeIndex];
+}
+
+int SearchContext::GetParent(int _nodeIndex) { return m_parents[_nodeIndex]; }
+float SearchContext::GetGCost(int _nodeIndex) { return m_gCosts[_nodeIndex]; }
+float SearchContext::GetFCost(int _nodeIndex) { return m_fCosts[_nodeIndex]; }
+
+// Returns the open list of the requested type
+OpenList* SearchContext::GetOpenList(int _openListType)
+{
+	if(_openListType == OPEN_LIST_BUCKET)
+		return &m_bucketOpenList;
+
+	return &m_heapOpenList;
+}
+
+// Returns a second context owned by this one, for algorithms that need to run smaller searches while their
+// main search is still using this context. It is only created the first time it is needed
+SearchContext* SearchContext::GetSubContext()
+{
+	if(!m_subContext)
+		m_subContext.reset(new SearchContext());
+
+	return m_subContext.get();
+}
+
+// Returns the buffer the tiles of a finished path are gathered in before they are written to the path
+std::vector<int>& SearchContext::GetPathTiles() { return m_pathTiles; }
+
+// Setters
+
+// Sets the search state of the given node and stamps it with the current search generation
+void SearchContext::SetSearchState(int _nodeIndex, int _state)
+{
+	m_generations[_nodeIndex] = m_searchGeneration;
+	m_states[_nodeIndex] = _state;
+}
+
+void SearchContext::SetParent(int _nodeIndex, int _parentIndex) { m_parents[_nodeIndex] = _parentIndex; }
+
+void SearchContext::SetCosts(int _nodeIndex, float _gCost, float _fCost)
+{
+	m_gCosts[_nodeIndex] = _gCost;
+	m_fCosts[_nodeIndex] = _fCost;
+}
+
+void SearchContext::SetBucketWidth(float _width) { m_bucketOpenList.SetBucketWidth(_width); }
+
+// Prepares the context for a new search over a map with the given number of nodes. The buffers are only
+// reallocated if the map size has changed. Starting a new generation marks every node as unvisited and
+// the generations are only cleared when the counter wraps around
+void SearchContext::BeginSearch(int _numNodes)
+{
+	if((int)m_generations.size() != _numNodes)
+	{
+		m_generations.assign(_numNodes, 0);
+		m_states.assign(_numNodes, NODE_UNVISITED);
+		m_parents.assign(_numNodes, -1);
+		m_gCosts.assign(_numNodes, 0.0f);
+		m_fCosts.assign(_numNodes, 0.0f);
+		m_searchGeneration = 0;
+	}
+
+	m_searchGeneration++;
+
+	if(m_searchGeneration == 0)
+	{
+		std::fill(m_generations.begin(), m_generations.end(), 0);
+		m_searchGeneration = 1;
+	}
+
+	m_heapOpenList.Reset(_numNodes);
+	m_bucketOpenList.Reset(_numNodes);
+}
\ No newline at end of file
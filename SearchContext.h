@@ -0,0 +1,61 @@
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+#include <vector>
+#include <memory>
+#include "OpenList.h"
+
+// States a node can be in during a search
+enum NodeSearchState
+{
+	NODE_UNVISITED = 0,
+	NODE_OPEN = 1,
+	NODE_CLOSED = 2
+};
+
+// Holds all of the data a single search writes to while it runs. Costs, parents and search states are
+// stored in separate arrays indexed by node index so the map itself is only read during a search. Each
+// thread that searches a map needs its own context, and reusing a context between searches reuses its
+// buffers without reallocating them
+class SearchContext
+{
+	public:
+		// Constructor and destructor
+		SearchContext();
+		~SearchContext();
+
+		// Getters
+		int GetSearchState(int _nodeIndex);
+		int GetParent(int _nodeIndex);
+		float GetGCost(int _nodeIndex);
+		float GetFCost(int _nodeIndex);
+
+		OpenList* GetOpenList(int _openListType);
+		SearchContext* GetSubContext();
+		std::vector<int>& GetPathTiles();
+
+		// Setters
+		void SetSearchState(int _nodeIndex, int _state);
+		void SetParent(int _nodeIndex, int _parentIndex);
+		void SetCosts(int _nodeIndex, float _gCost, float _fCost);
+		void SetBucketWidth(float _width);
+
+		void BeginSearch(int _numNodes);
+
+	private:
+		unsigned int m_searchGeneration;
+
+		std::vector<unsigned int> m_generations;
+		std::vector<unsigned char> m_states;
+		std::vector<int> m_parents;
+		std::vector<float> m_gCosts;
+		std::vector<float> m_fCosts;
+		std::vector<int> m_pathTiles;
+
+		BinaryHeapOpenList m_heapOpenList;
+		BucketOpenList m_bucketOpenList;
+
+		std::unique_ptr<SearchContext> m_subContext;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef SEARCHPOLICIES_H
+#define SEARCHPOLICIES_H
+
+#include "Node.h"
+#include "OccupancyMap.h"
+#include "Directions.h"
+
+// Policy types the best first search is compiled against. Everything they decide is fixed for the whole of a
+// query, so the map picks one combination before the search starts and each combination gets its own loop
+// with no checks on the algorithm, the connectivity or the type of entity left inside it
+
+// A Star orders the open list by F cost
+struct AStarPolicy
+{
+	static const bool c_useHeuristic = true;
+};
+
+// Dijkstra's algorithm orders the open list by G cost and never needs the heuristic
+struct DijkstraPolicy
+{
+	static const bool c_useHeuristic = false;
+};
+
+// Straight directions, in the order they appear in the full list of directions
+const int c_orthogonalDirs[4] = { DIR_NORTH, DIR_WEST, DIR_EAST, DIR_SOUTH };
+
+// Nodes link to all eight of their neighbours
+struct EightConnected
+{
+	static const int c_numDirections = NUM_DIRECTIONS;
+
+	static int GetDirection(int _i) { return _i; }
+};
+
+// Nodes only link to the four neighbours that share an edge with them
+struct FourConnected
+{
+	static const int c_numDirections = 4;
+
+	static int GetDirection(int _i) { return c_orthogonalDirs[_i]; }
+};
+
+// The player pays extra to move onto nodes near an enemy, as given by the map's occupancy layer
+struct PlayerCost
+{
+	static float CalcGCost(Node &_node, int _nodeIndex, OccupancyMap *_occupancy, float _gCost, float _parentTerrainCost, float _parentGCost) { return _node.CalcPlayerGCost(_gCost, _parentTerrainCost, _parentGCost, _occupancy->GetCostScale(_nodeIndex)); }
+};
+
+// Enemies only pay for the terrain, so the occupancy layer is never read for them
+struct EnemyCost
+{
+	static float CalcGCost(Node &_node, int /*_nodeIndex*/, OccupancyMap* /*_occupancy*/, float _gCost, float _parentTerrainCost, float _parentGCost) { return _node.CalcEnemyGCost(_gCost, _parentTerrainCost, _parentGCost); }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "ThreadPool.h"
+
+// Constructor - initialises member variables and starts the worker threads
+ThreadPool::ThreadPool(int _numWorkers)
+{
+	m_stopping = false;
+	m_batchNumber = 0;
+	m_activeWorkers = 0;
+	m_tasksRemaining = 0;
+	m_task = nullptr;
+
+	if(_numWorkers < 1)
+		_numWorkers = 1;
+
+	for(int i = 0; i < _numWorkers; i++)
+		m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+
+	for(int i = 0; i < _numWorkers; i++)
+		m_threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+}
+
+// Destructor - wakes every worker so it can see the pool is stopping and waits for them to finish
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_batchCondition.notify_all();
+
+	for(std::thread &thread : m_threads)
+		thread.join();
+}
+
+// Getters
+
+int ThreadPool::GetNumWorkers() { return m_threads.size(); }
+
+// Runs the task once for every task number from 0 up to the number of tasks and returns when they have all
+// finished. The task is given the task number and the index of the worker running it, so it can use data
+// that belongs to that worker without locking. Only one batch runs at a time
+void ThreadPool::Run(int _numTasks, const std::function<void(int, int)> &_task)
+{
+	if(_numTasks <= 0)
+		return;
+
+	std::lock_guard<std::mutex> runLock(m_runMutex);
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// Hands each worker an equal block of neighbouring task numbers
+	int numWorkers = m_queues.size();
+
+	for(int i = 0; i < numWorkers; i++)
+	{
+		std::lock_guard<std::mutex> queueLock(m_queues[i]->mutex);
+
+		for(int task = i * _numTasks / numWorkers; task < (i + 1) * _numTasks / numWorkers; task++)
+			m_queues[i]->tasks.push_back(task);
+	}
+
+	m_task = &_task;
+	m_tasksRemaining = _numTasks;
+	m_batchNumber++;
+
+	// Waits for every worker to stop looking for tasks as well as for the tasks to finish, so none of them can
+	// pick up a task from the next batch while still holding this one
+	m_batchCondition.notify_all();
+	m_doneCondition.wait(lock, [this] { return m_tasksRemaining == 0 && m_activeWorkers == 0; });
+
+	m_task = nullptr;
+}
+
+// Takes the next task for the given worker from the front of its own queue, or steals one from the back of
+// another worker's queue if its own is empty. Returns false if every queue is empty
+bool ThreadPool::PopTask(int _workerIndex, int &_taskIndex)
+{
+	int numWorkers = m_queues.size();
+
+	{
+		WorkerQueue &queue = *m_queues[_workerIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if(!queue.tasks.empty())
+		{
+			_taskIndex = queue.tasks.front();
+			queue.tasks.pop_front();
+			return true;
+		}
+	}
+
+	for(int i = 1; i < numWorkers; i++)
+	{
+		WorkerQueue &queue = *m_queues[(_workerIndex + i) % numWorkers];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if(!queue.tasks.empty())
+		{
+			_taskIndex = queue.tasks.back();
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Main loop of each worker thread. Waits for a new batch, runs tasks until none are left and then waits again.
+// A worker that only wakes up after the batch it was woken for has finished goes straight back to sleep
+void ThreadPool::WorkerLoop(int _workerIndex)
+{
+	unsigned int lastBatch = 0;
+
+	while(true)
+	{
+		const std::function<void(int, int)> *task;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_batchCondition.wait(lock, [this, lastBatch] { return m_stopping || m_batchNumber != lastBatch; });
+
+			if(m_stopping)
+				return;
+
+			lastBatch = m_batchNumber;
+			task = m_task;
+
+			if(task == nullptr)
+				continue;
+
+			m_activeWorkers++;
+		}
+
+		int taskIndex;
+
+		while(PopTask(_workerIndex, taskIndex))
+		{
+			(*task)(taskIndex, _workerIndex);
+			m_tasksRemaining--;
+		}
+
+		// The last worker to run out of tasks wakes the thread waiting on the batch
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if(--m_activeWorkers == 0 && m_tasksRemaining == 0)
+			m_doneCondition.notify_all();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Persistent pool of worker threads that runs batches of numbered tasks. Each worker has its own queue of
+// tasks and takes from the front of it, and once it is empty steals from the back of the other workers'
+// queues so that a worker given slow tasks doesn't hold up the batch. The threads sleep between batches
+// and are only stopped when the pool is destroyed
+class ThreadPool
+{
+	public:
+		// Constructor and destructor
+		ThreadPool(int _numWorkers);
+		~ThreadPool();
+
+		// Getters
+		int GetNumWorkers();
+
+		void Run(int _numTasks, const std::function<void(int, int)> &_task);
+
+	private:
+		// Queue of task numbers belonging to a single worker
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<int> tasks;
+		};
+
+		bool PopTask(int _workerIndex, int &_taskIndex);
+		void WorkerLoop(int _workerIndex);
+
+		bool m_stopping;
+		unsigned int m_batchNumber;
+		int m_activeWorkers;
+		std::atomic<int> m_tasksRemaining;
+
+		const std::function<void(int, int)> *m_task;
+
+		std::vector<std::thread> m_threads;
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+		std::mutex m_runMutex;
+		std::mutex m_mutex;
+		std::condition_variable m_batchCondition;
+		std::condition_variable m_doneCondition;
+};
+
+#endif
\ No newline at end of file